@@ -0,0 +1,1009 @@
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#    include <Windows.h>
+// Windows.h must be included before Psapi.h
+#    include <Psapi.h>
+#elif defined(Q_OS_UNIX)
+#    include <sys/resource.h>
+#endif
+
+#include <qasjsonlines.h>
+#include <qcborreader.h>
+#include <qcborwriter.h>
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
+
+#include "Model/QDspxModel.h"
+
+// ----------------------------------
+// Allocation counter
+// ----------------------------------
+static std::atomic<quint64> g_allocCount(0);
+static std::atomic<quint64> g_allocBytes(0);
+
+#ifdef __GLIBC__
+// Count every malloc, including the ones of Qt containers
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(n * size, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+}
+#else
+// Only C++ allocations can be counted portably
+void *operator new(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+// ----------------------------------
+// Peak resident memory
+// ----------------------------------
+static void resetPeakRss() {
+#ifdef Q_OS_LINUX
+    // Writing 5 resets the peak RSS of the process
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+    if (fp) {
+        fputs("5", fp);
+        fclose(fp);
+    }
+#endif
+}
+
+static qint64 peakRss() {
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return qint64(pmc.PeakWorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#    ifdef Q_OS_MACOS
+    return qint64(usage.ru_maxrss);
+#    else
+    return qint64(usage.ru_maxrss) * 1024;
+#    endif
+#else
+    return 0;
+#endif
+}
+
+// Heap and other private pages currently resident, mapped files are not included
+static qint64 anonRss() {
+#ifdef Q_OS_LINUX
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp) {
+        return 0;
+    }
+    char line[256];
+    long long kb = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "RssAnon: %lld", &kb) == 1) {
+            break;
+        }
+    }
+    fclose(fp);
+    return qint64(kb) * 1024;
+#else
+    return 0;
+#endif
+}
+
+// ----------------------------------
+// Synthetic project
+// ----------------------------------
+struct Shape {
+    int tracks = 8;
+    int clips = 8;
+    int notes = 64;
+    int points = 64;
+};
+
+static QDspx::ParamInfo makeParam(const Shape &shape, int seed) {
+    QDspx::ParamInfo info;
+
+    auto anchor = QDspx::ParamAnchorRef::create();
+    for (int i = 0; i < shape.points; ++i) {
+        anchor->nodes.append(QDspx::AnchorPoint(i * 120, (seed * 31 + i * 17) % 1200 - 600,
+                                                i % 3 == 0 ? QDspx::AnchorPoint::Hermite : QDspx::AnchorPoint::Linear));
+    }
+    info.org.append(anchor);
+
+    auto curve = QDspx::ParamFreeRef::create(seed * 480);
+    for (int i = 0; i < shape.points; ++i) {
+        curve->values.append((seed * 13 + i * 7) % 2400 - 1200);
+    }
+    info.edited.append(curve);
+
+    return info;
+}
+
+static QDspx::ClipRef makeClip(const Shape &shape, int track, int index) {
+    const int seed = track * shape.clips + index;
+
+    // One of four clips refers to an audio file
+    if (index % 4 == 3) {
+        auto clip = QDspx::AudioClipRef::create();
+        clip->time = QDspx::ClipTime(index * 19200, 19200);
+        clip->name = QString("Audio %1").arg(seed);
+        clip->path = QString("audio/track%1/clip%2.wav").arg(track).arg(index);
+        return clip;
+    }
+
+    auto clip = QDspx::SingingClipRef::create();
+    clip->time = QDspx::ClipTime(index * 19200, 19200);
+    clip->name = QString("Singing %1").arg(seed);
+    clip->control = QDspx::Control(-0.5 * (seed % 7), seed % 5 == 0);
+
+    static const char *const lyrics[] = {"la", "shi", "a", "ka", "ne", "mo", "ri", "yo"};
+    for (int i = 0; i < shape.notes; ++i) {
+        QDspx::Note note(i * 240, 240, 48 + (seed + i * 5) % 36);
+        note.lyric = QString::fromLatin1(lyrics[(seed + i) % 8]);
+
+        QDspx::Phoneme cons;
+        cons.type = QDspx::Phoneme::Ahead;
+        cons.token = note.lyric.left(1);
+        cons.duration = 60;
+        QDspx::Phoneme vowel;
+        vowel.token = note.lyric.mid(1);
+        note.phonemes.org = {cons, vowel};
+
+        note.vibrato.points = {QDspx::DoublePoint(0, 0), QDspx::DoublePoint(0.25, 1), QDspx::DoublePoint(1, 0.5)};
+        clip->notes->append(note);
+    }
+    clip->params->pitch = makeParam(shape, seed);
+    clip->params->energy = makeParam(shape, seed + 1);
+
+    QJsonObject source;
+    source.insert("singer", QString("voice%1").arg(seed % 3));
+    QJsonObject sources;
+    sources.insert("main", source);
+    clip->sources = QJsonValue(sources);
+    return clip;
+}
+
+static QDspxModel makeModel(const Shape &shape) {
+    QDspxModel model;
+    model.metadata.version = "1.0.0";
+    model.metadata.name = "bench";
+    model.metadata.author = "qas_bench";
+
+    model.content.timeline.timeSignatures = {QDspx::TimeSignature(0, 4, 4), QDspx::TimeSignature(7680, 3, 4)};
+    model.content.timeline.tempos = {QDspx::Tempo(0, 120), QDspx::Tempo(7680, 96.5)};
+    model.content.timeline.labels = {QDspx::Label(0, "Intro"), QDspx::Label(7680, "Verse")};
+
+    for (int i = 0; i < shape.tracks; ++i) {
+        QDspx::Track track;
+        track.name = QString("Track %1").arg(i + 1);
+        track.control = QDspx::TrackControl(-1.5, (i % 5 - 2) * 0.25, false, i == 0);
+        for (int j = 0; j < shape.clips; ++j) {
+            track.clips.append(makeClip(shape, i, j));
+        }
+        model.content.tracks.append(track);
+    }
+    return model;
+}
+
+// Decode every lazy member as if all clips were opened
+static void openClips(const QDspxModel &model) {
+    for (const auto &track : model.content.tracks) {
+        for (const auto &clip : track.clips) {
+            if (clip->type == QDspx::Clip::Singing) {
+                const auto &singing = *clip.staticCast<QDspx::SingingClip>();
+                singing.notes.get();
+                singing.params.get();
+            }
+        }
+    }
+}
+
+// ----------------------------------
+// Paths
+// ----------------------------------
+struct Path {
+    const char *name;
+    std::function<QByteArray(const QDspxModel &)> save;
+    std::function<bool(const QByteArray &, QDspxModel *)> load;
+    std::function<bool(const QByteArray &, QDspxModel *)> reload; // Into a loaded model, optional
+    std::function<bool(const QByteArray &, const QAS::FieldMask &, QDspxModel *)> partial; // Optional
+    std::function<bool(const QByteArray &)> validate;                                      // Optional
+    std::function<QByteArray(const QDspxModel &)> parallelSave;                            // Optional
+    std::function<bool(const QByteArray &, QDspxModel *)> parallelLoad;                    // Optional
+};
+
+static std::vector<Path> paths() {
+    return {
+        {
+            "dom",
+            [](const QDspxModel &model) {
+                return QJsonDocument(qAsClassToJson(model)).toJson(QJsonDocument::Compact);
+            },
+            [](const QByteArray &data, QDspxModel *out) {
+                QJsonParseError err;
+                QJsonDocument doc = QJsonDocument::fromJson(data, &err);
+                return err.error == QJsonParseError::NoError && qAsJsonTryGetClass(doc.object(), out);
+            },
+            nullptr,
+        },
+        {
+            "stream",
+            [](const QDspxModel &model) { return qAsClassToJsonData(model, QAS::JsonWriter::Compact); },
+            [](const QByteArray &data, QDspxModel *out) { return qAsJsonTryParseClass(data, out); },
+            [](const QByteArray &data, QDspxModel *out) { return qAsJsonTryUpdateClass(data, out); },
+            [](const QByteArray &data, const QAS::FieldMask &mask, QDspxModel *out) {
+                return qAsJsonTryGetClassPartial(data, mask, out);
+            },
+            [](const QByteArray &data) { return qAsJsonValidate<QDspxModel>(data); },
+            [](const QDspxModel &model) {
+                QByteArray data;
+                QAS::JsonWriter writer(&data, QAS::JsonWriter::Compact);
+                writer.setThreadPool(QThreadPool::globalInstance());
+                writer << model;
+                return data;
+            },
+            [](const QByteArray &data, QDspxModel *out) {
+                QAS::JsonReader reader(data);
+                reader.setThreadPool(QThreadPool::globalInstance());
+                reader >> *out;
+                return reader.good() && reader.atEnd();
+            },
+        },
+        {
+            "cbor",
+            [](const QDspxModel &model) { return qAsClassToCbor(model); },
+            [](const QByteArray &data, QDspxModel *out) { return qAsCborTryGetClass(data, out); },
+            [](const QByteArray &data, QDspxModel *out) { return qAsCborTryUpdateClass(data, out); },
+            [](const QByteArray &data, const QAS::FieldMask &mask, QDspxModel *out) {
+                return qAsCborTryGetClassPartial(data, mask, out);
+            },
+            [](const QByteArray &data) { return qAsCborValidate<QDspxModel>(data); },
+            nullptr,
+            [](const QByteArray &data, QDspxModel *out) {
+                QAS::CborReader reader(data);
+                reader.setThreadPool(QThreadPool::globalInstance());
+                reader >> *out;
+                return reader.good() && reader.atEnd();
+            },
+        },
+    };
+}
+
+// ----------------------------------
+// Measure
+// ----------------------------------
+struct Result {
+    qint64 bestNs = 0;
+    qint64 totalNs = 0;
+    quint64 allocs = 0;
+    quint64 allocBytes = 0;
+    qint64 peakRss = 0;
+};
+
+template <class F>
+static Result measure(int iterations, F func) {
+    Result res;
+    res.bestNs = std::numeric_limits<qint64>::max();
+
+    resetPeakRss();
+    for (int i = 0; i < iterations; ++i) {
+        quint64 allocs = g_allocCount.load();
+        quint64 allocBytes = g_allocBytes.load();
+
+        QElapsedTimer timer;
+        timer.start();
+        func();
+        qint64 ns = timer.nsecsElapsed();
+
+        res.allocs += g_allocCount.load() - allocs;
+        res.allocBytes += g_allocBytes.load() - allocBytes;
+        res.totalNs += ns;
+        res.bestNs = std::min(res.bestNs, ns);
+    }
+    res.peakRss = peakRss();
+
+    res.allocs /= quint64(iterations);
+    res.allocBytes /= quint64(iterations);
+    return res;
+}
+
+static void report(bool csv, const char *path, const char *op, qint64 size, int iterations, const Result &res) {
+    double mbps = res.bestNs > 0 ? double(size) / 1048576.0 / (double(res.bestNs) / 1e9) : 0;
+    double meanMs = double(res.totalNs) / iterations / 1e6;
+    if (csv) {
+        printf("%s,%s,%lld,%.3f,%.3f,%.2f,%llu,%llu,%lld\n", path, op, size, double(res.bestNs) / 1e6, meanMs, mbps,
+               res.allocs, res.allocBytes, res.peakRss);
+    } else {
+        printf("%-8s %-8s %12lld %10.3f %10.3f %10.2f %12llu %14llu %10.1f\n", path, op, size,
+               double(res.bestNs) / 1e6, meanMs, mbps, res.allocs, res.allocBytes, res.peakRss / 1048576.0);
+    }
+    fflush(stdout);
+}
+
+// ----------------------------------
+// Container micro benchmark
+// ----------------------------------
+static void reportContainer(bool csv, const char *name, const char *op, int count, const Result &res) {
+    double perElement = count > 0 ? double(res.allocs) / count : 0;
+    if (csv) {
+        printf("%s,%s,%d,%.3f,%llu,%.3f\n", name, op, count, double(res.bestNs) / 1e6, res.allocs, perElement);
+    } else {
+        printf("%-8s %-12s %10d %10.3f %12llu %12.3f\n", name, op, count, double(res.bestNs) / 1e6, res.allocs,
+               perElement);
+    }
+    fflush(stdout);
+}
+
+// Converts a container of count elements both ways, the input of each load is prepared outside the timing
+template <class T>
+static void measureContainer(bool csv, int iterations, const char *name, int count, const T &value) {
+    QAS::JsonStream dom;
+    dom << value;
+    const QByteArray text = qAsClassToJsonData(value, QAS::JsonWriter::Compact);
+
+    Result saveRes = measure(iterations, [&]() {
+        QAS::JsonStream tmp;
+        tmp << value;
+    });
+    reportContainer(csv, name, "dom save", count, saveRes);
+
+    Result loadRes = measure(iterations, [&]() {
+        QAS::JsonStream tmpStream(dom.data());
+        T tmp;
+        tmpStream >> tmp;
+    });
+    reportContainer(csv, name, "dom load", count, loadRes);
+
+    Result streamRes = measure(iterations, [&]() {
+        QAS::JsonReader reader(text);
+        T tmp;
+        reader >> tmp;
+    });
+    reportContainer(csv, name, "stream load", count, streamRes);
+}
+
+static void measureContainers(bool csv, int iterations, int count) {
+    if (csv) {
+        printf("container,op,count,best_ms,allocs,allocs_per_element\n");
+    } else {
+        printf("%-8s %-12s %10s %10s %12s %12s\n", "type", "op", "count", "best ms", "allocs", "per element");
+    }
+
+    QVector<int> ints;
+    QStringList strings;
+    QMap<QString, int> map;
+    QList<QDspx::Note> notes;
+    for (int i = 0; i < count; ++i) {
+        ints.append(i);
+        strings.append(QString("string %1").arg(i));
+        map.insert(QString("key %1").arg(i), i);
+
+        QDspx::Note note(i * 240, 240, 60);
+        note.lyric = QString("la");
+        notes.append(note);
+    }
+
+    measureContainer(csv, iterations, "ints", count, ints);
+    measureContainer(csv, iterations, "strings", count, strings);
+    measureContainer(csv, iterations, "map", count, map);
+    measureContainer(csv, iterations, "notes", count, notes);
+}
+
+// ----------------------------------
+// Integer benchmark
+// ----------------------------------
+// Reads and writes 64-bit ids of every magnitude, through the DOM, through the reader as doubles the way integers
+// were read before, and exactly
+static void measureIntegers(bool csv, int iterations, int count) {
+    if (csv) {
+        printf("container,op,count,best_ms,allocs,allocs_per_element\n");
+    } else {
+        printf("%-8s %-12s %10s %10s %12s %12s\n", "type", "op", "count", "best ms", "allocs", "per element");
+    }
+
+    // Below 2^62 so that the double path can't overflow
+    QVector<qint64> ids;
+    quint64 x = 88172645463325252ull;
+    for (int i = 0; i < count; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const qint64 id = qint64(x >> (2 + i % 62));
+        ids.append(i % 2 ? -id : id);
+    }
+    const QByteArray text = qAsClassToJsonData(ids, QAS::JsonWriter::Compact);
+
+    Result domWriteRes = measure(iterations, [&]() {
+        QJsonArray arr;
+        for (qint64 id : ids) {
+            arr.append(id);
+        }
+        QJsonDocument(arr).toJson(QJsonDocument::Compact);
+    });
+    reportContainer(csv, "ints64", "dom write", count, domWriteRes);
+
+    Result writeRes = measure(iterations, [&]() { qAsClassToJsonData(ids, QAS::JsonWriter::Compact); });
+    reportContainer(csv, "ints64", "write", count, writeRes);
+
+    QVector<qint64> loaded;
+    auto changed = [&]() {
+        int n = 0;
+        for (int i = 0; i < count; ++i) {
+            n += i >= loaded.size() || loaded.at(i) != ids.at(i);
+        }
+        return n;
+    };
+
+    Result domReadRes = measure(iterations, [&]() {
+        QAS::JsonStream stream(QJsonDocument::fromJson(text).array());
+        stream >> loaded;
+    });
+    reportContainer(csv, "ints64", "dom read", count, domReadRes);
+    const int domLost = changed();
+
+    Result doubleRes = measure(iterations, [&]() {
+        QAS::JsonReader reader(text);
+        reader.beginArray();
+        loaded.clear();
+        double d = 0;
+        while (reader.nextElement() && reader.readDouble(&d)) {
+            loaded.append(qint64(d));
+        }
+    });
+    reportContainer(csv, "ints64", "double read", count, doubleRes);
+    const int doubleLost = changed();
+
+    Result readRes = measure(iterations, [&]() {
+        QAS::JsonReader reader(text);
+        reader.setInPlace(true);
+        reader >> loaded;
+    });
+    reportContainer(csv, "ints64", "read", count, readRes);
+    const int lost = changed();
+
+    if (!csv) {
+        printf("\nchanged values: dom read %d, double read %d, read %d\n", domLost, doubleLost, lost);
+    }
+}
+
+// ----------------------------------
+// Double benchmark
+// ----------------------------------
+// Reads and writes parameter curve values through the DOM and directly, and compares the text with QJsonDocument's
+static void measureDoubles(bool csv, int iterations, int count) {
+    if (csv) {
+        printf("container,op,count,best_ms,allocs,allocs_per_element\n");
+    } else {
+        printf("%-8s %-12s %10s %10s %12s %12s\n", "type", "op", "count", "best ms", "allocs", "per element");
+    }
+
+    // Cents with a fraction and gains in dB, as edited curves hold them
+    QVector<double> values;
+    for (int i = 0; i < count; ++i) {
+        const double x = i * 0.01;
+        values.append(i % 2 ? std::sin(x) * 1200.0 + i % 7 * 0.125 : 20.0 * std::log10(1.0 + i % 1000 / 1000.0));
+    }
+    QJsonArray arr;
+    for (double value : values) {
+        arr.append(value);
+    }
+    const QByteArray domText = QJsonDocument(arr).toJson(QJsonDocument::Compact);
+    const QByteArray text = qAsClassToJsonData(values, QAS::JsonWriter::Compact);
+
+    Result domWriteRes = measure(iterations, [&]() { QJsonDocument(arr).toJson(QJsonDocument::Compact); });
+    reportContainer(csv, "doubles", "dom write", count, domWriteRes);
+
+    Result writeRes = measure(iterations, [&]() { qAsClassToJsonData(values, QAS::JsonWriter::Compact); });
+    reportContainer(csv, "doubles", "write", count, writeRes);
+
+    QVector<double> loaded;
+    auto changed = [&]() {
+        int n = 0;
+        for (int i = 0; i < count; ++i) {
+            n += i >= loaded.size() || loaded.at(i) != values.at(i);
+        }
+        return n;
+    };
+
+    Result domReadRes = measure(iterations, [&]() {
+        QAS::JsonStream stream(QJsonDocument::fromJson(text).array());
+        stream >> loaded;
+    });
+    reportContainer(csv, "doubles", "dom read", count, domReadRes);
+    const int domLost = changed();
+
+    Result readRes = measure(iterations, [&]() {
+        QAS::JsonReader reader(text);
+        reader.setInPlace(true);
+        reader >> loaded;
+    });
+    reportContainer(csv, "doubles", "read", count, readRes);
+    const int lost = changed();
+
+    if (!csv) {
+        printf("\nchanged values: dom read %d, read %d, same text as QJsonDocument: %s\n", domLost, lost,
+               text == domText ? "yes" : "no");
+    }
+}
+
+// ----------------------------------
+// JSON Lines benchmark
+// ----------------------------------
+static QDspx::Note makeRecord(int index) {
+    QDspx::Note note(index * 240, 240, 60 + index % 12);
+    note.lyric = QString("la");
+    return note;
+}
+
+// Reads count note records of one stream, through the DOM once per line, on one thread and on the global pool
+static void measureLines(bool csv, int iterations, int count) {
+    if (csv) {
+        printf("container,op,count,best_ms,allocs,allocs_per_element\n");
+    } else {
+        printf("%-8s %-12s %10s %10s %12s %12s\n", "type", "op", "count", "best ms", "allocs", "per element");
+    }
+
+    QByteArray text;
+    Result writeRes = measure(iterations, [&]() {
+        QBuffer buf;
+        buf.open(QIODevice::WriteOnly);
+        QAS::JsonLinesWriter<QDspx::Note> writer(&buf);
+        for (int i = 0; i < count; ++i) {
+            writer.write(makeRecord(i));
+        }
+        writer.flush();
+        text = buf.data();
+    });
+    reportContainer(csv, "lines", "write", count, writeRes);
+
+    Result domRes = measure(iterations, [&]() {
+        QBuffer buf;
+        buf.setData(text);
+        buf.open(QIODevice::ReadOnly);
+        QDspx::Note note;
+        while (!buf.atEnd()) {
+            const QByteArray line = buf.readLine();
+            qAsJsonTryGetClass(QJsonDocument::fromJson(line).object(), &note);
+        }
+    });
+    reportContainer(csv, "lines", "dom read", count, domRes);
+
+    auto read = [&](QThreadPool *pool) {
+        QBuffer buf;
+        buf.setData(text);
+        buf.open(QIODevice::ReadOnly);
+        QAS::JsonLinesReader<QDspx::Note> reader(&buf);
+        reader.setThreadPool(pool);
+        QDspx::Note note;
+        int n = 0;
+        while (reader.readNext(&note)) {
+            n++;
+        }
+        if (n != count) {
+            fprintf(stderr, "lines: read %d of %d records\n", n, count);
+        }
+    };
+
+    Result readRes = measure(iterations, [&]() { read(nullptr); });
+    reportContainer(csv, "lines", "read", count, readRes);
+
+    Result poolRes = measure(iterations, [&]() { read(QThreadPool::globalInstance()); });
+    reportContainer(csv, "lines", "pool read", count, poolRes);
+}
+
+// ----------------------------------
+// Large document benchmark
+// ----------------------------------
+// Writes an array of tracks to a file until it reaches mb megabytes and reads it back from a mapping one track
+// at a time, the peak column is the largest private resident memory seen, which stays flat with the size
+static int measureHuge(bool csv, const Shape &shape, qint64 mb) {
+    const QDspxModel model = makeModel(shape);
+    const QList<QDspx::Track> &tracks = model.content.tracks;
+    if (tracks.isEmpty()) {
+        fprintf(stderr, "huge: no tracks\n");
+        return 1;
+    }
+
+    const QString fileName = QDir::temp().filePath("qas_bench_huge.json");
+    const qint64 target = mb * 1024 * 1024;
+    qint64 size = 0;
+    qint64 count = 0;
+    qint64 peak = 0;
+
+    if (csv) {
+        printf("path,op,bytes,best_ms,mean_ms,mb_per_s,allocs,alloc_bytes,peak_rss\n");
+    } else {
+        printf("tracks=%d clips=%d notes=%d points=%d size=%lld MB\n\n", shape.tracks, shape.clips, shape.notes,
+               shape.points, mb);
+        printf("%-8s %-8s %12s %10s %10s %10s %12s %14s %10s\n", "path", "op", "bytes", "best ms", "mean ms", "MB/s",
+               "allocs", "alloc bytes", "peak MB");
+    }
+
+    bool ok = true;
+    Result writeRes = measure(1, [&]() {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            ok = false;
+            return;
+        }
+        QAS::JsonWriter writer(&file, QAS::JsonWriter::Compact);
+        writer.beginArray();
+        while (file.pos() < target && !writer.hasError()) {
+            writer << tracks.at(int(count % tracks.size()));
+            if (++count % 256 == 0) {
+                peak = qMax(peak, anonRss());
+            }
+        }
+        writer.endArray();
+        ok = writer.flush();
+        size = file.size();
+    });
+    if (!ok) {
+        fprintf(stderr, "huge: failed to write %s\n", fileName.toLocal8Bit().constData());
+        QFile::remove(fileName);
+        return 1;
+    }
+    writeRes.peakRss = peak;
+    report(csv, "huge", "write", size, 1, writeRes);
+
+    // Each track is read into the same object, only the mapping grows with the file
+    peak = 0;
+    Result readRes = measure(1, [&]() {
+        QFile file(fileName);
+        uchar *map = file.open(QIODevice::ReadOnly) ? file.map(0, file.size()) : nullptr;
+        if (!map) {
+            ok = false;
+            return;
+        }
+        QAS::JsonReader reader(reinterpret_cast<const char *>(map), file.size());
+        reader.setInPlace(true);
+        reader.beginArray();
+
+        QDspx::Track track;
+        qint64 n = 0;
+        while (ok && reader.nextElement()) {
+            reader >> track;
+            ok = reader.good() && track.name == tracks.at(int(n % tracks.size())).name;
+            if (++n % 256 == 0) {
+                peak = qMax(peak, anonRss());
+            }
+        }
+        ok = ok && reader.good() && reader.atEnd() && n == count;
+    });
+    QFile::remove(fileName);
+    if (!ok) {
+        fprintf(stderr, "huge: round trip failed\n");
+        return 1;
+    }
+    readRes.peakRss = peak;
+    report(csv, "huge", "read", size, 1, readRes);
+
+    // One flat array of numbers, every value is a scalar written without a nested object
+    count = 0;
+    peak = 0;
+    writeRes = measure(1, [&]() {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            ok = false;
+            return;
+        }
+        QAS::JsonWriter writer(&file, QAS::JsonWriter::Compact);
+        writer.beginArray();
+        while (file.pos() < target && !writer.hasError()) {
+            writer.writeDouble(double(count) * 0.25);
+            if (++count % 65536 == 0) {
+                peak = qMax(peak, anonRss());
+            }
+        }
+        writer.endArray();
+        ok = writer.flush();
+        size = file.size();
+    });
+    if (!ok) {
+        fprintf(stderr, "huge: failed to write %s\n", fileName.toLocal8Bit().constData());
+        QFile::remove(fileName);
+        return 1;
+    }
+    writeRes.peakRss = peak;
+    report(csv, "scalars", "write", size, 1, writeRes);
+
+    peak = 0;
+    readRes = measure(1, [&]() {
+        QFile file(fileName);
+        uchar *map = file.open(QIODevice::ReadOnly) ? file.map(0, file.size()) : nullptr;
+        if (!map) {
+            ok = false;
+            return;
+        }
+        QAS::JsonReader reader(reinterpret_cast<const char *>(map), file.size());
+        reader.beginArray();
+
+        double d = 0;
+        qint64 n = 0;
+        while (ok && reader.nextElement()) {
+            reader >> d;
+            ok = reader.good() && d == double(n) * 0.25;
+            if (++n % 65536 == 0) {
+                peak = qMax(peak, anonRss());
+            }
+        }
+        ok = ok && reader.good() && reader.atEnd() && n == count;
+    });
+    QFile::remove(fileName);
+    if (!ok) {
+        fprintf(stderr, "huge: scalar round trip failed\n");
+        return 1;
+    }
+    readRes.peakRss = peak;
+    report(csv, "scalars", "read", size, 1, readRes);
+    return 0;
+}
+
+static void usage() {
+    printf("Usage: qas_bench [options]\n"
+           "\n"
+           "Options:\n"
+           "  --tracks <n>      Tracks of the project (default 8)\n"
+           "  --clips <n>       Clips per track (default 8)\n"
+           "  --notes <n>       Notes per singing clip (default 64)\n"
+           "  --points <n>      Points per parameter curve (default 64)\n"
+           "  --iterations <n>  Runs of each measure (default 10)\n"
+           "  --path <name>     Only run the path, can be repeated\n"
+           "  --input <file>    Load a json project instead of generating one\n"
+           "  --containers <n>  Measure containers of n elements instead of a project\n"
+           "  --integers <n>    Measure n 64-bit integers instead of a project\n"
+           "  --doubles <n>     Measure n doubles instead of a project\n"
+           "  --lines <n>       Measure a JSON Lines stream of n records instead of a project\n"
+           "  --huge <mb>       Round trip a document of mb megabytes through a temporary file\n"
+           "  --csv             Print comma-separated values\n"
+           "  -h, --help        Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+
+    Shape shape;
+    int iterations = 10;
+    QStringList only;
+    QString input;
+    int containers = 0;
+    int integers = 0;
+    int doubles = 0;
+    int lines = 0;
+    qint64 huge = 0;
+    bool csv = false;
+
+    const QStringList args = a.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--csv") {
+            csv = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        } else if (hasValue && arg == "--tracks") {
+            shape.tracks = args.at(++i).toInt();
+        } else if (hasValue && arg == "--clips") {
+            shape.clips = args.at(++i).toInt();
+        } else if (hasValue && arg == "--notes") {
+            shape.notes = args.at(++i).toInt();
+        } else if (hasValue && arg == "--points") {
+            shape.points = args.at(++i).toInt();
+        } else if (hasValue && arg == "--iterations") {
+            iterations = qMax(1, args.at(++i).toInt());
+        } else if (hasValue && arg == "--path") {
+            only.append(args.at(++i));
+        } else if (hasValue && arg == "--input") {
+            input = args.at(++i);
+        } else if (hasValue && arg == "--containers") {
+            containers = args.at(++i).toInt();
+        } else if (hasValue && arg == "--integers") {
+            integers = args.at(++i).toInt();
+        } else if (hasValue && arg == "--doubles") {
+            doubles = args.at(++i).toInt();
+        } else if (hasValue && arg == "--lines") {
+            lines = args.at(++i).toInt();
+        } else if (hasValue && arg == "--huge") {
+            huge = args.at(++i).toLongLong();
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (containers > 0) {
+        measureContainers(csv, iterations, containers);
+        return 0;
+    }
+
+    if (integers > 0) {
+        measureIntegers(csv, iterations, integers);
+        return 0;
+    }
+
+    if (doubles > 0) {
+        measureDoubles(csv, iterations, doubles);
+        return 0;
+    }
+
+    if (lines > 0) {
+        measureLines(csv, iterations, lines);
+        return 0;
+    }
+
+    if (huge > 0) {
+        return measureHuge(csv, shape, huge);
+    }
+
+    QDspxModel model;
+    if (!input.isEmpty()) {
+        if (!model.load(input)) {
+            fprintf(stderr, "Failed to load %s\n", input.toLocal8Bit().constData());
+            return 1;
+        }
+    } else {
+        model = makeModel(shape);
+    }
+
+    if (csv) {
+        printf("path,op,bytes,best_ms,mean_ms,mb_per_s,allocs,alloc_bytes,peak_rss\n");
+    } else {
+        printf("tracks=%d clips=%d notes=%d points=%d iterations=%d\n\n", shape.tracks, shape.clips, shape.notes,
+               shape.points, iterations);
+        printf("%-8s %-8s %12s %10s %10s %10s %12s %14s %10s\n", "path", "op", "bytes", "best ms", "mean ms", "MB/s",
+               "allocs", "alloc bytes", "peak MB");
+    }
+
+    int ret = 0;
+    for (const Path &path : paths()) {
+        if (!only.isEmpty() && !only.contains(QString::fromLatin1(path.name))) {
+            continue;
+        }
+
+        // Check the path round trips before timing it
+        QByteArray data = path.save(model);
+        QDspxModel loaded;
+        if (!path.load(data, &loaded) || path.save(loaded) != data) {
+            fprintf(stderr, "%s: round trip failed\n", path.name);
+            ret = 1;
+            continue;
+        }
+
+        Result saveRes = measure(iterations, [&]() { data = path.save(model); });
+        report(csv, path.name, "save", data.size(), iterations, saveRes);
+
+        Result loadRes = measure(iterations, [&]() {
+            QDspxModel tmp;
+            path.load(data, &tmp);
+        });
+        report(csv, path.name, "load", data.size(), iterations, loadRes);
+
+        Result openRes = measure(iterations, [&]() {
+            QDspxModel tmp;
+            path.load(data, &tmp);
+            openClips(tmp);
+        });
+        report(csv, path.name, "open", data.size(), iterations, openRes);
+
+        // Lists longer than the threshold are converted on all cores
+        if (path.parallelSave) {
+            if (path.parallelSave(model) != data) {
+                fprintf(stderr, "%s: parallel save failed\n", path.name);
+                ret = 1;
+                continue;
+            }
+            Result psaveRes = measure(iterations, [&]() { path.parallelSave(model); });
+            report(csv, path.name, "psave", data.size(), iterations, psaveRes);
+        }
+        if (path.parallelLoad) {
+            QDspxModel tmp;
+            if (!path.parallelLoad(data, &tmp) || path.save(tmp) != data) {
+                fprintf(stderr, "%s: parallel load failed\n", path.name);
+                ret = 1;
+                continue;
+            }
+            Result ploadRes = measure(iterations, [&]() {
+                QDspxModel tmp;
+                path.parallelLoad(data, &tmp);
+            });
+            report(csv, path.name, "pload", data.size(), iterations, ploadRes);
+        }
+
+        // Load again into the same model, the storage of the previous load is reused
+        if (path.reload) {
+            if (!path.reload(data, &loaded) || path.save(loaded) != data) {
+                fprintf(stderr, "%s: reload failed\n", path.name);
+                ret = 1;
+                continue;
+            }
+            Result reloadRes = measure(iterations, [&]() { path.reload(data, &loaded); });
+            report(csv, path.name, "reload", data.size(), iterations, reloadRes);
+        }
+
+        // Only what an index of projects needs
+        if (path.partial) {
+            const QAS::FieldMask mask({"metadata.name", "content.tracks.name"});
+            QDspxModel indexed;
+            if (!path.partial(data, mask, &indexed) || indexed.metadata.name != model.metadata.name ||
+                indexed.content.tracks.size() != model.content.tracks.size()) {
+                fprintf(stderr, "%s: partial load failed\n", path.name);
+                ret = 1;
+                continue;
+            }
+            Result indexRes = measure(iterations, [&]() {
+                QDspxModel tmp;
+                path.partial(data, mask, &tmp);
+            });
+            report(csv, path.name, "index", data.size(), iterations, indexRes);
+        }
+
+        // Check only, as for an upload before accepting it
+        if (path.validate) {
+            if (!path.validate(data)) {
+                fprintf(stderr, "%s: validation failed\n", path.name);
+                ret = 1;
+                continue;
+            }
+            Result validateRes = measure(iterations, [&]() { path.validate(data); });
+            report(csv, path.name, "validate", data.size(), iterations, validateRes);
+        }
+    }
+
+    return ret;
+}
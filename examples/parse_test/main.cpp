@@ -0,0 +1,657 @@
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#include <qasjsonlines.h>
+#include <qcborreader.h>
+#include <qcborwriter.h>
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
+
+#include "parse_test.h"
+
+// Every input goes through the DOM, JsonReader, qAsJsonValidate, CborReader and qAsCborValidate, the statuses must
+// be the expected one and the values decoded by the paths that succeed must be the same.
+
+typedef QAS::JsonStream::Status Status;
+
+enum Path {
+    Dom = 1,
+    Reader = 2,
+    Validate = 4,
+    Cbor = 8,
+    CborValidate = 16,
+
+    JsonPaths = Dom | Reader | Validate,
+    AllPaths = JsonPaths | Cbor | CborValidate,
+};
+
+static int failures = 0;
+
+void printSeparator(const QString& title) {
+    qDebug() << QString("=== %1 ===").arg(title);
+}
+
+QString statusName(Status status) {
+    switch (status) {
+        case QAS::JsonStream::Ok:
+            return "Ok";
+        case QAS::JsonStream::KeyNotFound:
+            return "KeyNotFound";
+        case QAS::JsonStream::TypeNotMatch:
+            return "TypeNotMatch";
+        case QAS::JsonStream::UnlistedValue:
+            return "UnlistedValue";
+        case QAS::JsonStream::ConstraintViolation:
+            return "ConstraintViolation";
+        case QAS::JsonStream::SyntaxError:
+            return "SyntaxError";
+        default:
+            break;
+    }
+    return QString::number(status);
+}
+
+// CBOR of the same document, built from the DOM
+QByteArray toCbor(const QByteArray &json) {
+    QByteArray data;
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (doc.isObject()) {
+        QAS::CborWriter writer(&data);
+        writer << doc.object();
+    }
+    return data;
+}
+
+template <class T>
+Status parseDom(const QByteArray &json, T *out) {
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &err);
+    if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+        return QAS::JsonStream::SyntaxError;
+    }
+    QAS::JsonStream stream(doc.object());
+    stream >> *out;
+    return stream.status();
+}
+
+template <class T>
+Status parseReader(const QByteArray &json, T *out) {
+    QAS::JsonReader reader(json);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.status();
+}
+
+template <class T>
+Status parseCbor(const QByteArray &cbor, T *out) {
+    QAS::CborReader reader(cbor);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.status();
+}
+
+template <class T>
+bool check(const QString &title, const QByteArray &json, const QByteArray &cbor, Status expected,
+           int paths = AllPaths, T *result = nullptr) {
+    struct Run {
+        const char *name;
+        Status status;
+        QByteArray value;
+    };
+    QList<Run> runs;
+
+    auto addRun = [&](const char *name, Status status, const T *var) {
+        runs.append({name, status, var ? qAsClassToJsonData(*var, QAS::JsonWriter::Compact) : QByteArray()});
+    };
+
+    T dom{}, read{}, decoded{};
+    Status status = QAS::JsonStream::Ok;
+    if (paths & Dom) {
+        status = parseDom(json, &dom);
+        addRun("JsonStream", status, status == QAS::JsonStream::Ok ? &dom : nullptr);
+    }
+    if (paths & Reader) {
+        status = parseReader(json, &read);
+        addRun("JsonReader", status, status == QAS::JsonStream::Ok ? &read : nullptr);
+    }
+    if (paths & Validate) {
+        qAsJsonValidate<T>(json, &status);
+        addRun("qAsJsonValidate", status, nullptr);
+    }
+    if (paths & Cbor) {
+        status = parseCbor(cbor, &decoded);
+        addRun("CborReader", status, status == QAS::JsonStream::Ok ? &decoded : nullptr);
+    }
+    if (paths & CborValidate) {
+        qAsCborValidate<T>(cbor, &status);
+        addRun("qAsCborValidate", status, nullptr);
+    }
+
+    bool ok = true;
+    QByteArray value;
+    for (const auto &run : runs) {
+        if (run.status != expected) {
+            qDebug().noquote() << "[FAIL]" << title << ":" << run.name << "returns" << statusName(run.status)
+                               << ", expected" << statusName(expected);
+            ok = false;
+            continue;
+        }
+        if (run.value.isEmpty()) {
+            continue;
+        }
+        if (value.isEmpty()) {
+            value = run.value;
+        } else if (run.value != value) {
+            qDebug().noquote() << "[FAIL]" << title << ":" << run.name << "decodes" << run.value << ", others decode"
+                               << value;
+            ok = false;
+        }
+    }
+    if (ok) {
+        qDebug().noquote() << "[OK]" << title << ":" << statusName(expected)
+                           << (value.isEmpty() ? QString() : QString::fromUtf8(value));
+    } else {
+        ++failures;
+    }
+
+    if (result) {
+        *result = (paths & Reader) ? read : decoded;
+    }
+    return ok;
+}
+
+template <class T>
+bool check(const QString &title, const QByteArray &json, Status expected, int paths = AllPaths) {
+    return check<T>(title, json, toCbor(json), expected, paths);
+}
+
+// A check of something else than the status of the paths
+void verify(bool ok, const QString &title) {
+    if (ok) {
+        qDebug().noquote() << "[OK]" << title;
+    } else {
+        qDebug().noquote() << "[FAIL]" << title;
+        ++failures;
+    }
+}
+
+void testConstraints() {
+    printSeparator("Testing Constraints");
+
+    const QByteArray valid = R"({"level": 50, "ratio": 0.5, "name": "alice", "tag": "abc", "kind": "a",
+                                 "version": "1.0", "mode": "fast"})";
+    check<Limits>("All constraints met", valid, QAS::JsonStream::Ok);
+
+    const QList<QPair<QString, QByteArray>> violations = {
+        {"MINIMUM", R"("level": -1)"},
+        {"MAXIMUM", R"("level": 101)"},
+        {"EXCLUSIVE_MINIMUM", R"("ratio": 0.0)"},
+        {"EXCLUSIVE_MAXIMUM", R"("ratio": 1.0)"},
+        {"MIN_LENGTH", R"("name": "al")"},
+        {"MAX_LENGTH", R"("name": "alexandria")"},
+        {"PATTERN", R"("tag": "ABC")"},
+        {"ENUM", R"("kind": "c")"},
+        {"CONST", R"("version": "1.1")"},
+    };
+    for (const auto &violation : violations) {
+        // The later duplicate key wins
+        QByteArray json = valid;
+        json.chop(1);
+        json += ", " + violation.second + "}";
+        check<Limits>(violation.first + " violated", json, QAS::JsonStream::ConstraintViolation);
+    }
+
+    QByteArray unlisted = valid;
+    unlisted.replace(R"("fast")", R"("slow")");
+    check<Limits>("Unlisted enum value", unlisted, QAS::JsonStream::UnlistedValue);
+
+    QByteArray missing = valid;
+    missing.replace(R"("level": 50, )", "");
+    check<Limits>("Missing member", missing, QAS::JsonStream::KeyNotFound);
+
+    QByteArray mistyped = valid;
+    mistyped.replace(R"("level": 50)", R"("level": "50")");
+    check<Limits>("Mistyped member", mistyped, QAS::JsonStream::TypeNotMatch);
+
+    // The DOM reports the first failing or missing member in declaration order, whatever the order of the keys
+    QByteArray several = R"({"version": "1.1", "name": "al", "level": "50", "mode": "fast"})";
+    check<Limits>("Several failures", several, QAS::JsonStream::TypeNotMatch, Dom);
+    several.replace(R"("level": "50", )", "");
+    check<Limits>("Failures after a missing member", several, QAS::JsonStream::KeyNotFound, Dom);
+}
+
+void testMalformed() {
+    printSeparator("Testing Malformed Input");
+
+    const QByteArray valid = R"({"value": 1.5})";
+    const QByteArray cbor = toCbor(valid);
+
+    for (int size = 1; size < valid.size(); ++size) {
+        check<Reals>(QString("Truncated text at %1").arg(size), valid.left(size), QAS::JsonStream::SyntaxError,
+                     JsonPaths);
+    }
+    for (int size = 1; size < cbor.size(); ++size) {
+        check<Reals>(QString("Truncated CBOR at %1").arg(size), QByteArray(), cbor.left(size),
+                     QAS::JsonStream::SyntaxError, Cbor | CborValidate);
+    }
+    check<Reals>("Trailing data", valid + "{}", QAS::JsonStream::SyntaxError, JsonPaths);
+
+    check<Limits>("Bad escape", R"({"level": 50, "ratio": 0.5, "name": "al\qce"})", QAS::JsonStream::SyntaxError,
+                  JsonPaths);
+    check<Limits>("Bad unicode escape", R"({"level": 50, "ratio": 0.5, "name": "al\u12x4ce"})",
+                  QAS::JsonStream::SyntaxError, JsonPaths);
+}
+
+void testNesting() {
+    printSeparator("Testing Nesting Limit");
+
+    auto nested = [](int depth) {
+        return R"({"root": )" + QByteArray(depth, '[') + QByteArray(depth, ']') + "}";
+    };
+    auto nestedCbor = [](int depth) {
+        QByteArray data;
+        QAS::CborWriter writer(&data);
+        writer.beginObject(1);
+        writer.writeKey(QLatin1String("root"));
+        for (int i = 0; i < depth; ++i) {
+            writer.beginArray(i + 1 < depth ? 1 : 0);
+        }
+        for (int i = 0; i < depth; ++i) {
+            writer.endArray();
+        }
+        writer.endObject();
+        return data;
+    };
+
+    check<Tree>("Nesting of 1000", nested(1000), nestedCbor(1000), QAS::JsonStream::Ok);
+    check<Tree>("Nesting of 2000", nested(2000), nestedCbor(2000), QAS::JsonStream::SyntaxError);
+}
+
+void testNumbers() {
+    printSeparator("Testing Number Edges");
+
+    auto integers = [](std::function<void(QAS::CborWriter &)> big, std::function<void(QAS::CborWriter &)> ubig) {
+        QByteArray data;
+        QAS::CborWriter writer(&data);
+        writer.beginObject(3);
+        writer.writeKey(QLatin1String("big"));
+        big(writer);
+        writer.writeKey(QLatin1String("ubig"));
+        ubig(writer);
+        writer.writeKey(QLatin1String("small"));
+        writer.writeInteger(-1);
+        writer.endObject();
+        return data;
+    };
+    auto integer = [](qint64 l) {
+        return [l](QAS::CborWriter &writer) { writer.writeInteger(l); };
+    };
+    auto unsignedInteger = [](quint64 ul) {
+        return [ul](QAS::CborWriter &writer) { writer.writeUnsigned(ul); };
+    };
+    auto negative = [](quint64 n) {
+        return [n](QAS::CborWriter &writer) { writer.stream().append(QCborNegativeInteger(n)); };
+    };
+
+    // The DOM goes through double, so only the text readers see the exact 64-bit values
+    Integers var{};
+    check<Integers>("-2^63 and 2^64-1", R"({"big": -9223372036854775808, "ubig": 18446744073709551615, "small": -1})",
+                    integers(integer(std::numeric_limits<qint64>::min()),
+                             unsignedInteger(std::numeric_limits<quint64>::max())),
+                    QAS::JsonStream::Ok, AllPaths & ~Dom, &var);
+    if (var.big == std::numeric_limits<qint64>::min() && var.ubig == std::numeric_limits<quint64>::max()) {
+        qDebug() << "[OK] 64-bit edges are kept exactly";
+    } else {
+        qDebug() << "[FAIL] 64-bit edges are not kept exactly";
+        ++failures;
+    }
+
+    check<Integers>("2^63 into qint64", R"({"big": 9223372036854775808, "ubig": 0, "small": -1})",
+                    integers(unsignedInteger(quint64(1) << 63), unsignedInteger(0)), QAS::JsonStream::TypeNotMatch,
+                    AllPaths & ~Dom);
+    check<Integers>("-2^63-1 into qint64", R"({"big": -9223372036854775809, "ubig": 0, "small": -1})",
+                    integers(negative(quint64(1) << 63 | 1), unsignedInteger(0)), QAS::JsonStream::TypeNotMatch,
+                    AllPaths & ~Dom);
+    check<Integers>("2^64 into quint64", R"({"big": 0, "ubig": 18446744073709551616, "small": -1})",
+                    integers(integer(0), [](QAS::CborWriter &writer) { writer.writeDouble(18446744073709551616.0); }),
+                    QAS::JsonStream::TypeNotMatch, AllPaths & ~Dom);
+    check<Integers>("2^63 as a float into quint64", R"({"big": 0, "ubig": 9223372036854775808.0, "small": -1})",
+                    integers(integer(0), [](QAS::CborWriter &writer) { writer.writeDouble(9223372036854775808.0); }),
+                    QAS::JsonStream::Ok, AllPaths & ~Dom, &var);
+    if (var.ubig == quint64(1) << 63) {
+        qDebug() << "[OK] Floats up to 2^64 are read into quint64";
+    } else {
+        qDebug() << "[FAIL] Floats up to 2^64 are not read into quint64";
+        ++failures;
+    }
+    check<Integers>("-1 into quint64", R"({"big": 0, "ubig": -1, "small": -1})",
+                    integers(integer(0), integer(-1)), QAS::JsonStream::TypeNotMatch, AllPaths & ~Dom);
+    check<Integers>("-2^64 into qint64", R"({"big": -18446744073709551616, "ubig": 0, "small": -1})",
+                    integers(negative(0), unsignedInteger(0)), QAS::JsonStream::TypeNotMatch, AllPaths & ~Dom);
+    check<Integers>("2^31 into int", R"({"big": 0, "ubig": 0, "small": 2147483648})",
+                    QAS::JsonStream::TypeNotMatch);
+
+    Reals real{};
+    check<Reals>("-0", R"({"value": -0})", toCbor(R"({"value": -0.0})"), QAS::JsonStream::Ok, AllPaths & ~Dom,
+                 &real);
+    if (real.value == 0 && std::signbit(real.value)) {
+        qDebug() << "[OK] -0 keeps its sign";
+    } else {
+        qDebug() << "[FAIL] -0 loses its sign";
+        ++failures;
+    }
+    check<Reals>("-0.0", R"({"value": -0.0})", QAS::JsonStream::Ok);
+}
+
+void testTypedArrays() {
+    printSeparator("Testing Typed Arrays");
+
+    auto lists = [](quint64 intsTag, const QByteArray &ints, quint64 bytesTag, const QByteArray &bytes) {
+        QByteArray data;
+        QAS::CborWriter writer(&data);
+        writer.beginObject(3);
+        writer.writeKey(QLatin1String("ints"));
+        writer.writeTypedArray(intsTag, ints.constData(), ints.size());
+        writer.writeKey(QLatin1String("bytes"));
+        writer.writeTypedArray(bytesTag, bytes.constData(), bytes.size());
+        writer.writeKey(QLatin1String("reals"));
+        writer.beginArray(1);
+        writer.writeDouble(0.5);
+        writer.endArray();
+        writer.endObject();
+        return data;
+    };
+    auto array = [](std::initializer_list<qint16> values) {
+        QByteArray data;
+        for (qint16 v : values) {
+            data.append(char(v & 0xFF)).append(char((v >> 8) & 0xFF));
+        }
+        return data;
+    };
+    auto realArray = [](std::initializer_list<double> values) {
+        QByteArray data;
+        for (double v : values) {
+            quint64 bits;
+            memcpy(&bits, &v, sizeof(bits));
+            for (int i = 0; i < 8; ++i) {
+                data.append(char((bits >> (i * 8)) & 0xFF));
+            }
+        }
+        return data;
+    };
+
+    // Typed arrays are CBOR only, the text is the same document as plain arrays
+    check<Lists>("Typed arrays", R"({"ints": [1, -300], "bytes": [1, 2], "reals": [0.5]})",
+                 lists(77, array({1, -300}), 64, QByteArray("\x01\x02", 2)), QAS::JsonStream::Ok);
+    check<Lists>("Typed array out of range", R"({"ints": [1], "bytes": [1, 300], "reals": [0.5]})",
+                 lists(77, array({1}), 77, array({1, 300})), QAS::JsonStream::TypeNotMatch);
+    check<Lists>("Typed array with NaN", QByteArray(), lists(86, realArray({1.5, std::nan("")}), 64, QByteArray()),
+                 QAS::JsonStream::TypeNotMatch, Cbor | CborValidate);
+    check<Lists>("Typed array of bad size", QByteArray(), lists(77, QByteArray("\x01\x00\x02", 3), 64, QByteArray()),
+                 QAS::JsonStream::SyntaxError, Cbor | CborValidate);
+}
+
+void testUpdate() {
+    printSeparator("Testing In-Place Updates");
+
+    const QByteArray json = R"({"ints": [1], "bytes": [], "reals": [3.5, 4.5]})";
+    const QByteArray expected = qAsClassToJsonData(qAsJsonParseClass<Lists>(json), QAS::JsonWriter::Compact);
+
+    // A shorter list is read over the existing elements and keeps its storage
+    Lists lists{};
+    lists.ints = {7, 8, 9};
+    lists.reals = {0.5, 1.5, 2.5};
+    const double *reals = lists.reals.constData();
+    bool ok = qAsJsonTryUpdateClass(json, &lists);
+    verify(ok && qAsClassToJsonData(lists, QAS::JsonWriter::Compact) == expected, "Json update reads the new values");
+    verify(lists.reals.constData() == reals, "Json update keeps the list storage");
+
+    lists.reals = {0.5, 1.5, 2.5};
+    reals = lists.reals.constData();
+    ok = qAsCborTryUpdateClass(toCbor(json), &lists);
+    verify(ok && qAsClassToJsonData(lists, QAS::JsonWriter::Compact) == expected, "CBOR update reads the new values");
+    verify(lists.reals.constData() == reals, "CBOR update keeps the list storage");
+
+    // With constraints the update goes through a copy, a rejected input leaves the object as it was
+    Limits limits = qAsJsonParseClass<Limits>(R"({"level": 50, "ratio": 0.5, "name": "alice", "tag": "abc",
+                                                   "kind": "a", "version": "1.0", "mode": "fast"})");
+    const QByteArray before = qAsClassToJsonData(limits, QAS::JsonWriter::Compact);
+    const QByteArray violated = R"({"level": 60, "ratio": 0.5, "name": "al", "tag": "abc", "kind": "a",
+                                    "version": "1.0", "mode": "safe"})";
+    ok = qAsJsonTryUpdateClass(violated, &limits);
+    verify(!ok && qAsClassToJsonData(limits, QAS::JsonWriter::Compact) == before, "Rejected json update is dropped");
+    ok = qAsCborTryUpdateClass(toCbor(violated), &limits);
+    verify(!ok && qAsClassToJsonData(limits, QAS::JsonWriter::Compact) == before, "Rejected CBOR update is dropped");
+}
+
+void testLazy() {
+    printSeparator("Testing Lazy Members");
+
+    // The DOM keeps a json value, which is written back with sorted keys
+    check<Deferred>("Lazy member", R"({"lists": {"ints": [1], "bytes": [2], "reals": [0.5]}, "count": 3})",
+                    QAS::JsonStream::Ok, AllPaths & ~Dom);
+
+    // The owner is read without looking into the member, the error shows on the first access
+    const QByteArray bad = R"({"lists": {"ints": ["x"], "bytes": [], "reals": []}, "count": 3})";
+    auto firstAccess = [](const Deferred &var) {
+        const bool deferred = !var.lists.isLoaded();
+        var.lists.get();
+        return deferred && var.lists.status() == QAS::JsonStream::TypeNotMatch;
+    };
+
+    Deferred dom{}, read{}, decoded{};
+    verify(parseDom(bad, &dom) == QAS::JsonStream::Ok && firstAccess(dom), "JsonStream fails on the first access");
+    verify(parseReader(bad, &read) == QAS::JsonStream::Ok && firstAccess(read),
+           "JsonReader fails on the first access");
+    verify(parseCbor(toCbor(bad), &decoded) == QAS::JsonStream::Ok && firstAccess(decoded),
+           "CborReader fails on the first access");
+
+    // Nothing is kept when validating, so the member is checked at once
+    check<Deferred>("Lazy member checked by validation", bad, QAS::JsonStream::TypeNotMatch,
+                    Validate | CborValidate);
+}
+
+void testRawJson() {
+    printSeparator("Testing Raw Json Members");
+
+    check<Opaque>("Raw member", R"({"extra": {"a": [1, 2], "b": null}, "count": 1})", QAS::JsonStream::Ok);
+
+    // Json text is written back as it was read, key order and escapes included
+    const QByteArray text = R"({"b": [1, 2], "a": "\u00e9"})";
+    Opaque var{};
+    parseReader(R"({"extra": )" + text + R"(, "count": 1})", &var);
+    verify(qAsClassToJsonData(var, QAS::JsonWriter::Compact) == R"({"extra":{"b":[1,2],"a":"\u00e9"},"count":1})",
+           "Compact output drops only the whitespace");
+    verify(qAsClassToJsonData(var).contains(text), "Indented output keeps the text");
+
+    verify(qAsClassToJsonData(Opaque{}, QAS::JsonWriter::Compact) == R"({"extra":{},"count":0})",
+           "Default raw member is an empty object");
+}
+
+void testPartial() {
+    printSeparator("Testing Partial Reads");
+
+    const QAS::FieldMask mask({"level", "mode"});
+    auto partial = [&mask](const QByteArray &json) {
+        Limits read{}, decoded{};
+        const bool ok = qAsJsonTryGetClassPartial(json, mask, &read);
+        if (ok != qAsCborTryGetClassPartial(toCbor(json), mask, &decoded)) {
+            qDebug() << "[FAIL] JsonReader and CborReader disagree";
+            ++failures;
+        }
+        return ok && read.level == decoded.level && read.mode == decoded.mode;
+    };
+
+    // Members not selected may be missing, or have any value since they are skipped
+    const QByteArray selected = R"({"level": 5, "mode": "safe"})";
+    check<Limits>("Selected members only", selected, QAS::JsonStream::KeyNotFound);
+    verify(partial(selected), "Partial read of the selected members");
+    verify(partial(R"({"name": 5, "level": 5, "tag": [], "mode": "safe"})"), "Partial read skips other members");
+
+    // Selected members are still required and checked
+    verify(!partial(R"({"mode": "safe"})"), "Partial read requires the selected members");
+    verify(!partial(R"({"level": 500, "mode": "safe"})"), "Partial read checks the selected members");
+}
+
+void testJsonLines() {
+    printSeparator("Testing JSON Lines");
+
+    // Records come in order, a bad line is reported with its number and reading goes on, blank lines are skipped
+    const QByteArray text = "{\"value\": 1}\n"
+                            "{\"value\": \"x\"}\n"
+                            "\r\n"
+                            "{\"value\": \n"
+                            "{\"value\": 5}";
+    const QStringList expected = {"1 Ok 1", "2 TypeNotMatch", "4 SyntaxError", "5 Ok 5"};
+
+    auto readAll = [&text](QThreadPool *pool) {
+        QBuffer buf;
+        buf.setData(text);
+        buf.open(QIODevice::ReadOnly);
+        QAS::JsonLinesReader<Reals> reader(&buf);
+        reader.setThreadPool(pool, 2);
+
+        QStringList records;
+        Reals record{};
+        while (true) {
+            const bool ok = reader.readNext(&record);
+            if (!ok && reader.status() == QAS::JsonStream::Ok) {
+                break;
+            }
+            QString line = QString::number(reader.lineNumber()) + " " + statusName(reader.status());
+            if (ok) {
+                line += " " + QString::number(record.value);
+            }
+            records.append(line);
+        }
+        return records;
+    };
+    verify(readAll(nullptr) == expected, "Records read in order on the calling thread");
+    verify(readAll(QThreadPool::globalInstance()) == expected, "Records read in order on the pool");
+
+    QBuffer buf;
+    buf.open(QIODevice::WriteOnly);
+    {
+        QAS::JsonLinesWriter<Reals> writer(&buf);
+        for (int i = 1; i <= 3; ++i) {
+            writer.write(Reals{i * 0.5});
+        }
+    }
+    verify(buf.data() == "{\"value\":0.5}\n{\"value\":1}\n{\"value\":1.5}\n", "Records written one per line");
+}
+
+void testParallel() {
+    printSeparator("Testing Parallel Lists");
+
+    // Elements after the threshold are decoded on the pool, some failing ones are in different chunks
+    auto batch = [](const QMap<int, QByteArray> &bad) {
+        QByteArray json = R"({"items": [)";
+        for (int i = 0; i < 200; ++i) {
+            json += (i ? ", " : "") + bad.value(i, R"({"value": )" + QByteArray::number(i) + "}");
+        }
+        return json + "]}";
+    };
+    auto parallel = [](const QByteArray &json, Batch *read, Batch *decoded) {
+        QAS::JsonReader reader(json);
+        reader.setThreadPool(QThreadPool::globalInstance(), 8);
+        reader >> *read;
+        const QByteArray cbor = toCbor(json); // The reader doesn't copy the data
+        QAS::CborReader cborReader(cbor);
+        cborReader.setThreadPool(QThreadPool::globalInstance(), 8);
+        cborReader >> *decoded;
+        return reader.status() == cborReader.status() ? reader.status() : QAS::JsonStream::Failed;
+    };
+
+    // The lowest failing index is reported, as by a sequential read
+    const QList<QPair<QString, QMap<int, QByteArray>>> inputs = {
+        {"No failure", {}},
+        {"Failure after the threshold", {{150, R"({"value": "x"})"}}},
+        {"Lowest of several failures", {{60, "{}"}, {150, R"({"value": "x"})"}, {190, "{}"}}},
+        {"Failure before the threshold", {{3, R"({"value": "x"})"}, {100, "{}"}}},
+    };
+    for (const auto &input : inputs) {
+        const QByteArray json = batch(input.second);
+        Batch sequential{}, read{}, decoded{};
+        const Status expected = parseReader(json, &sequential);
+        const Status status = parallel(json, &read, &decoded);
+        bool same = status == expected;
+        if (same && status == QAS::JsonStream::Ok) {
+            const QByteArray value = qAsClassToJsonData(sequential, QAS::JsonWriter::Compact);
+            same = qAsClassToJsonData(read, QAS::JsonWriter::Compact) == value &&
+                   qAsClassToJsonData(decoded, QAS::JsonWriter::Compact) == value;
+        }
+        verify(same, input.first + " : " + statusName(expected));
+    }
+}
+
+void testFiles() {
+    printSeparator("Testing File Loading");
+
+    const QString path = QDir::temp().filePath("qas_parse_test.dat");
+    auto writeFile = [&path](const QByteArray &data) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            qDebug().noquote() << "[FAIL] Can't write" << path;
+            ++failures;
+        }
+    };
+
+    Reals var{};
+    QFile::remove(path);
+    verify(!qAsJsonTryLoadFile(path, &var) && !qAsCborTryLoadFile(path, &var), "Missing file fails");
+
+    // An empty file isn't mapped, it's read and fails as empty input
+    writeFile(QByteArray());
+    verify(!qAsJsonTryLoadFile(path, &var) && !qAsCborTryLoadFile(path, &var), "Empty file fails");
+
+    const QByteArray json = R"({"value": 2.5})";
+    writeFile(json);
+    var = Reals{};
+    verify(qAsJsonTryLoadFile(path, &var) && var.value == 2.5, "Json file is read");
+    writeFile(toCbor(json));
+    var = Reals{};
+    verify(qAsCborTryLoadFile(path, &var) && var.value == 2.5, "CBOR file is read");
+
+    QFile::remove(path);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    qDebug() << "Testing Parse Paths";
+    qDebug() << "===================";
+
+    testConstraints();
+    testMalformed();
+    testNesting();
+    testNumbers();
+    testTypedArrays();
+    testUpdate();
+    testLazy();
+    testRawJson();
+    testPartial();
+    testJsonLines();
+    testParallel();
+    testFiles();
+
+    qDebug() << "===================";
+    if (failures == 0) {
+        qDebug() << "All parse tests completed!";
+    } else {
+        qDebug() << failures << "parse tests failed!";
+    }
+    return failures == 0 ? 0 : 1;
+}
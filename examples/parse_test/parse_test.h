@@ -0,0 +1,97 @@
+#ifndef PARSE_TEST_H
+#define PARSE_TEST_H
+
+#include "qaslazy.h"
+#include "qasrawjson.h"
+#include "qjsonstream.h"
+
+enum class Mode {
+    __qas_attr__("fast")
+    Fast,
+
+    __qas_attr__("safe")
+    Safe,
+};
+
+// One member per constraint type
+class Limits {
+public:
+    __qas_constraint__(MINIMUM 0 MAXIMUM 100)
+    int level;
+
+    __qas_constraint__(EXCLUSIVE_MINIMUM 0.0 EXCLUSIVE_MAXIMUM 1.0)
+    double ratio;
+
+    __qas_constraint__(MIN_LENGTH 3 MAX_LENGTH 8)
+    QString name;
+
+    __qas_constraint__(PATTERN "^[a-z]+$")
+    QString tag;
+
+    __qas_constraint__(ENUM ["a", "b"])
+    QString kind;
+
+    __qas_constraint__(CONST "1.0")
+    QString version;
+
+    Mode mode;
+};
+
+// Integers at the edges of the 64-bit types
+class Integers {
+public:
+    qint64 big;
+    quint64 ubig;
+    int small;
+};
+
+class Reals {
+public:
+    double value;
+};
+
+// Lists of numbers, written as typed arrays in CBOR
+class Lists {
+public:
+    QList<int> ints;
+    QList<quint8> bytes;
+    QVector<double> reals;
+};
+
+// Any json value, used for nesting
+class Tree {
+public:
+    QJsonValue root;
+};
+
+// Lists decoded on the first access
+class Deferred {
+public:
+    QAS::Lazy<Lists> lists;
+    int count;
+};
+
+// Any json value, kept as read
+class Opaque {
+public:
+    QAS::RawJson extra;
+    int count;
+};
+
+// Long enough to be read on the pool
+class Batch {
+public:
+    QList<Reals> items;
+};
+
+QAS_JSON_NS(Mode)
+QAS_JSON_NS(Limits)
+QAS_JSON_NS(Integers)
+QAS_JSON_NS(Reals)
+QAS_JSON_NS(Lists)
+QAS_JSON_NS(Tree)
+QAS_JSON_NS(Deferred)
+QAS_JSON_NS(Opaque)
+QAS_JSON_NS(Batch)
+
+#endif // PARSE_TEST_H
@@ -1,15 +1,17 @@
 #ifndef QDSPXBASE_H
 #define QDSPXBASE_H
 
+#include <qasrawjson.h>
 #include <qjsonstream.h>
 
 #include "DsCoreGlobal.h"
 
 namespace QDspx {
 
-    using Extra = QMap<QString, QJsonObject>;      // 其他参数，不定长
-    using Workspace = QMap<QString, QJsonObject>;  // 状态信息，不定长
-    using SourceInfo = QMap<QString, QJsonObject>; // 外部资源信息，不定长
+    // 原为 QMap<QString, QJsonObject>，现只保存原始字节，不解析；需要内容时调用 toValue()
+    using Extra = QAS::RawJson;      // 其他参数，不定长
+    using Workspace = QAS::RawJson;  // 状态信息，不定长
+    using SourceInfo = QAS::RawJson; // 外部资源信息，不定长
 
     // 主控
     struct DSCORE_API Control {
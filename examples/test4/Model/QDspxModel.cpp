@@ -1,30 +1,17 @@
 #include "QDspxModel.h"
 
 #include <QFile>
-#include <QJsonDocument>
+
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
 
 using namespace QDspx;
 
 QAS_USING_NAMESPACE
 
 bool Model::load(const QString &filename) {
-    // Read file
-    QFile file(filename);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
-    }
-    QByteArray data = file.readAll();
-    file.close();
-
-    // Parse json
-    QJsonParseError parseError{};
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
-        return false;
-    }
-
-    // Deserialize
-    return qAsJsonTryGetClass(doc.object(), this);
+    // Map file, parse and deserialize
+    return qAsJsonTryLoadFile(filename, this);
 }
 
 bool Model::save(const QString &filename) const {
@@ -35,8 +22,8 @@ bool Model::save(const QString &filename) const {
     }
 
     // Serialize and write
-    file.write(QJsonDocument(qAsClassToJson(*this)).toJson());
+    bool res = qAsClassWriteJson(*this, &file);
     file.close();
 
-    return true;
+    return res;
 }
@@ -1,15 +1,25 @@
 #include "QDspxParam.h"
 
+#include <qcborreader.h>
+#include <qcborwriter.h>
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
+
 QAS::JsonStream &QDspx::operator>>(QAS::JsonStream &_stream, QDspx::ParamCurveRef &_var) {
     QJsonObject _obj;
-    if (!QAS::JsonStreamUtils::parseAsObject(_stream, typeid(_var).name(), &_obj).good()) {
+    if (!QAS::JsonStreamUtils::parseAsObject(_stream, "QDspx::ParamCurveRef", &_obj).good()) {
         return _stream;
     }
 
     QDspx::ParamCurve _tmpVar{};
     QAS::JsonStream _tmpStream;
-    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "type", typeid(_tmpVar).name(),
-                                                               &_tmpVar.type)).good()) {
+    auto _it = _obj.constFind(QLatin1String("type"));
+    if (_it == _obj.constEnd()) {
+        _stream.setStatus(QAS::JsonStream::KeyNotFound);
+        return _stream;
+    }
+    if (!(_tmpStream = QAS::JsonStreamUtils::parseMemberValue(_it.value(), "type", "QDspx::ParamCurveRef",
+                                                              &_tmpVar.type)).good()) {
         _stream.setStatus(_tmpStream.status());
         return _stream;
     }
@@ -37,4 +47,38 @@ QAS::JsonStream &QDspx::operator<<(QAS::JsonStream &_stream, const QDspx::ParamC
 
     return _var->type == QDspx::ParamCurve::Anchor ? (_stream << *_var.dynamicCast<QDspx::ParamAnchor>()) :
            (_stream << *_var.dynamicCast<QDspx::ParamFree>());
+}
+
+QAS::JsonReader &QDspx::operator>>(QAS::JsonReader &_reader, QDspx::ParamCurveRef &_var) {
+    return QAS::JsonReaderUtils::parsePolymorphic(
+            _reader, _var, "type", "QDspx::ParamCurveRef", &QDspx::ParamCurve::type,
+            QAS::JsonReaderUtils::derivedClass<QDspx::ParamAnchor>(QDspx::ParamCurve::Anchor),
+            QAS::JsonReaderUtils::derivedClass<QDspx::ParamFree>(QDspx::ParamCurve::Free));
+}
+
+QAS::JsonWriter &QDspx::operator<<(QAS::JsonWriter &_writer, const QDspx::ParamCurveRef &_var) {
+    if (_var.isNull()) {
+        _writer.writeNull();
+        return _writer;
+    }
+
+    return _var->type == QDspx::ParamCurve::Anchor ? (_writer << *_var.dynamicCast<QDspx::ParamAnchor>()) :
+           (_writer << *_var.dynamicCast<QDspx::ParamFree>());
+}
+
+QAS::CborReader &QDspx::operator>>(QAS::CborReader &_reader, QDspx::ParamCurveRef &_var) {
+    return QAS::CborReaderUtils::parsePolymorphic(
+            _reader, _var, "type", "QDspx::ParamCurveRef", &QDspx::ParamCurve::type,
+            QAS::CborReaderUtils::derivedClass<QDspx::ParamAnchor>(QDspx::ParamCurve::Anchor),
+            QAS::CborReaderUtils::derivedClass<QDspx::ParamFree>(QDspx::ParamCurve::Free));
+}
+
+QAS::CborWriter &QDspx::operator<<(QAS::CborWriter &_writer, const QDspx::ParamCurveRef &_var) {
+    if (_var.isNull()) {
+        _writer.writeNull();
+        return _writer;
+    }
+
+    return _var->type == QDspx::ParamCurve::Anchor ? (_writer << *_var.dynamicCast<QDspx::ParamAnchor>()) :
+           (_writer << *_var.dynamicCast<QDspx::ParamFree>());
 }
\ No newline at end of file
@@ -70,6 +70,9 @@ namespace QDspx {
     QAS_JSON_NS(ParamInfo)
     QAS_JSON_NS(SingleParam)
     QAS_JSON_NS_IMPL(ParamCurveRef)
+    QAS_JSON_NS_READER_IMPL(ParamCurveRef)
+    QAS_JSON_NS_WRITER_IMPL(ParamCurveRef)
+    QAS_JSON_NS_CBOR_IMPL(ParamCurveRef)
 
 } // namespace QDspx
 
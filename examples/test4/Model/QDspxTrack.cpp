@@ -1,15 +1,25 @@
 #include "QDspxTrack.h"
 
+#include <qcborreader.h>
+#include <qcborwriter.h>
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
+
 QAS::JsonStream &QDspx::operator>>(QAS::JsonStream &_stream, QDspx::ClipRef &_var) {
     QJsonObject _obj;
-    if (!QAS::JsonStreamUtils::parseAsObject(_stream, typeid(_var).name(), &_obj).good()) {
+    if (!QAS::JsonStreamUtils::parseAsObject(_stream, "QDspx::ClipRef", &_obj).good()) {
         return _stream;
     }
 
     QDspx::Clip _tmpVar{};
     QAS::JsonStream _tmpStream;
-    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "type", typeid(_tmpVar).name(),
-                                                               &_tmpVar.type)).good()) {
+    auto _it = _obj.constFind(QLatin1String("type"));
+    if (_it == _obj.constEnd()) {
+        _stream.setStatus(QAS::JsonStream::KeyNotFound);
+        return _stream;
+    }
+    if (!(_tmpStream = QAS::JsonStreamUtils::parseMemberValue(_it.value(), "type", "QDspx::ClipRef",
+                                                              &_tmpVar.type)).good()) {
         _stream.setStatus(_tmpStream.status());
         return _stream;
     }
@@ -37,4 +47,38 @@ QAS::JsonStream &QDspx::operator<<(QAS::JsonStream &_stream, const QDspx::ClipRe
 
     return _var->type == QDspx::Clip::Singing ? (_stream << *_var.dynamicCast<QDspx::SingingClip>()) :
            (_stream << *_var.dynamicCast<QDspx::AudioClip>());
+}
+
+QAS::JsonReader &QDspx::operator>>(QAS::JsonReader &_reader, QDspx::ClipRef &_var) {
+    return QAS::JsonReaderUtils::parsePolymorphic(
+            _reader, _var, "type", "QDspx::ClipRef", &QDspx::Clip::type,
+            QAS::JsonReaderUtils::derivedClass<QDspx::SingingClip>(QDspx::Clip::Singing),
+            QAS::JsonReaderUtils::derivedClass<QDspx::AudioClip>(QDspx::Clip::Audio));
+}
+
+QAS::JsonWriter &QDspx::operator<<(QAS::JsonWriter &_writer, const QDspx::ClipRef &_var) {
+    if (_var.isNull()) {
+        _writer.writeNull();
+        return _writer;
+    }
+
+    return _var->type == QDspx::Clip::Singing ? (_writer << *_var.dynamicCast<QDspx::SingingClip>()) :
+           (_writer << *_var.dynamicCast<QDspx::AudioClip>());
+}
+
+QAS::CborReader &QDspx::operator>>(QAS::CborReader &_reader, QDspx::ClipRef &_var) {
+    return QAS::CborReaderUtils::parsePolymorphic(
+            _reader, _var, "type", "QDspx::ClipRef", &QDspx::Clip::type,
+            QAS::CborReaderUtils::derivedClass<QDspx::SingingClip>(QDspx::Clip::Singing),
+            QAS::CborReaderUtils::derivedClass<QDspx::AudioClip>(QDspx::Clip::Audio));
+}
+
+QAS::CborWriter &QDspx::operator<<(QAS::CborWriter &_writer, const QDspx::ClipRef &_var) {
+    if (_var.isNull()) {
+        _writer.writeNull();
+        return _writer;
+    }
+
+    return _var->type == QDspx::Clip::Singing ? (_writer << *_var.dynamicCast<QDspx::SingingClip>()) :
+           (_writer << *_var.dynamicCast<QDspx::AudioClip>());
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef QDSPXTRACK_H
 #define QDSPXTRACK_H
 
+#include <qaslazy.h>
+
 #include "QDspxNote.h"
 #include "QDspxParam.h"
 
@@ -61,8 +63,9 @@ namespace QDspx {
 
     // 人声区间
     struct DSCORE_API SingingClip : public Clip {
-        QList<Note> notes;
-        SingleParam params;
+        // 首次访问时解析，原为 QList<Note> 和 SingleParam，现通过 get()、* 或 -> 访问
+        QAS::Lazy<QList<Note>> notes;
+        QAS::Lazy<SingleParam> params;
 
         // 不定长信息
         SourceInfo sources;
@@ -90,6 +93,9 @@ namespace QDspx {
     QAS_JSON_NS(SingingClip)
     QAS_JSON_NS(Track)
     QAS_JSON_NS_IMPL(ClipRef)
+    QAS_JSON_NS_READER_IMPL(ClipRef)
+    QAS_JSON_NS_WRITER_IMPL(ClipRef)
+    QAS_JSON_NS_CBOR_IMPL(ClipRef)
 
 } // namespace QDspx
 
@@ -1,38 +1,36 @@
 #include <QCoreApplication>
-#include <QJsonDocument>
+#include <QDebug>
 #include <QFile>
 
+#include <qcborreader.h>
+#include <qcborwriter.h>
+#include <qjsonreader.h>
+#include <qjsonwriter.h>
+
 #include "Model/QDspxModel.h"
 
 int main(int argc, char *argv[]) {
     QCoreApplication a(argc, argv);
 
     if (argc > 1) {
-        QFile file(a.arguments().at(1));
-        if (file.open(QIODevice::ReadOnly)) {
-            QByteArray data = file.readAll();
-            file.close();
-            QJsonParseError parseError{};
-            QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-            if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
-                qDebug() << "Read file error.";
-                goto out;
+        QDspxModel model;
+        if (qAsJsonTryLoadFile(a.arguments().at(1), &model)) {
+            qDebug() << model.metadata.name;
+            QFile file("2.json");
+            if (file.open(QIODevice::WriteOnly)) {
+                qAsClassWriteJson(model, &file);
             }
+            file.close();
 
-            QDspxModel model;
-            if (qAsJsonTryGetClass(doc.object(), &model)) {
-                qDebug() << model.metadata.name;
-                file.setFileName("2.json");
-                if (file.open(QIODevice::WriteOnly)) {
-                    file.write(QJsonDocument(qAsClassToJson(model)).toJson());
-                }
-                file.close();
-            } else {
-                qDebug() << "Failed";
+            // Round trip through CBOR
+            QDspxModel model2;
+            if (qAsCborTryGetClass(qAsClassToCbor(model), &model2)) {
+                qDebug() << model2.metadata.name;
             }
+        } else {
+            qDebug() << "Failed";
         }
     }
 
-    out:
     return 0;
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ QAS_JSON_NS_IMPL(Gender);
 
 inline QAS::JsonStream &operator>>(QAS::JsonStream &_stream, Gender &_var) {
     QString _str;
-    if (!QAS::JsonStreamUtils::parseAsString(_stream, typeid(_var).name(), &_str).good()) {
+    if (!QAS::JsonStreamUtils::parseAsString(_stream, "Gender", &_str).good()) {
         return _stream;
     }
 
@@ -56,18 +56,18 @@ QAS_JSON_NS_IMPL(Rectangle)
 
 inline QAS::JsonStream &operator>>(QAS::JsonStream &_stream, Rectangle &_var) {
     QJsonObject _obj;
-    if (!QAS::JsonStreamUtils::parseAsObject(_stream, typeid(_var).name(), &_obj).good()) {
+    if (!QAS::JsonStreamUtils::parseAsObject(_stream, "Rectangle", &_obj).good()) {
         return _stream;
     }
 
     Rectangle _tmpVar{};
     QAS::JsonStream _tmpStream;
-    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "a", typeid(_tmpVar).name(),
+    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "a", "Rectangle",
                                                                &_tmpVar.a)).good()) {
         _stream.setStatus(_tmpStream.status());
         return _stream;
     }
-    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "b", typeid(_tmpVar).name(),
+    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, "b", "Rectangle",
                                                                &_tmpVar.b)).good()) {
         _stream.setStatus(_tmpStream.status());
         return _stream;
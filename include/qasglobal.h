@@ -33,6 +33,24 @@
 
 #define QAS_SET_OK(OK, VALUE) OK ? (*OK = VALUE) : (VALUE, false)
 
+// Type name in diagnostics, generated code passes a literal instead
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+#    include <typeinfo>
+#    define QAS_TYPE_NAME(VAR) typeid(VAR).name()
+#else
+#    define QAS_TYPE_NAME(VAR) "<unknown type>"
+#endif
+
+// Shortest round trip conversion of doubles, Qt's conversion is used without it
+#if defined(__has_include) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#    if __has_include(<charconv>)
+#        include <charconv>
+#        if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#            define QAS_HAS_TO_CHARS
+#        endif
+#    endif
+#endif
+
 
 // ----------------------------------
 // Namespace Macros
@@ -0,0 +1,365 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QASJSONLINES_H
+#define QASJSONLINES_H
+
+#include "qjsonreader.h"
+#include "qjsonwriter.h"
+#include "qjsonstream.h"
+
+#include <QIODevice>
+
+#include <algorithm>
+#include <utility>
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * JsonLinesReader reads a stream of records of the same type, one json value per line (JSON
+ * Lines or NDJSON). Blank lines are skipped and a line may end with "\r\n".
+ *
+ * The read buffer is kept between records and records are read into the caller's object
+ * reusing its storage. With a thread pool, records are decoded in batches on the pool and
+ * returned in the order of the input.
+ *
+ * The device is read until read() returns no data, a socket must be waited for by the caller.
+ *
+ */
+
+template <class T>
+class JsonLinesReader {
+public:
+    enum {
+        BufferSize = 64 * 1024,
+        BatchSize = 256,
+        BatchBytes = 16 * 1024 * 1024,
+    };
+
+    explicit JsonLinesReader(QIODevice *device);
+    ~JsonLinesReader() = default;
+
+    /* Decode up to batchSize records at once on the pool, nullptr decodes on the calling thread, a batch
+       stops early once it holds BatchBytes of text */
+    void setThreadPool(QThreadPool *pool, int batchSize = BatchSize);
+
+    inline QThreadPool *threadPool() const {
+        return q_pool;
+    }
+
+    /* Reads the next record into out, returns false at the end or if the record fails, in which
+       case status() is set and the next call continues with the following line */
+    bool readNext(T *out);
+
+    /* No more records */
+    bool atEnd();
+
+    /* Status of the last record */
+    inline JsonStream::Status status() const {
+        return q_status;
+    }
+
+    /* Line of the last record, starting from 1 */
+    inline qint64 lineNumber() const {
+        return q_lineNumber;
+    }
+
+private:
+    struct Record {
+        int offset;
+        int size;
+        qint64 line;
+        JsonStream::Status status;
+    };
+
+    QIODevice *q_device;
+    QByteArray q_buf;
+    int q_pos;
+    int q_scanned; // Bytes after q_pos known to have no line break
+    bool q_eof;
+    qint64 q_line;
+
+    QThreadPool *q_pool;
+    int q_batchSize;
+    QByteArray q_batch;
+    QVector<Record> q_records;
+    QVector<T> q_values;
+    int q_next;
+
+    JsonStream::Status q_status;
+    qint64 q_lineNumber;
+
+    bool nextLine(const char **line, int *size);
+    bool fillBatch();
+
+    static JsonStream::Status parse(const char *line, int size, qint64 lineNumber, T *out);
+};
+
+/**
+ * JsonLinesWriter writes records as compact json, one per line, through a buffer which is
+ * kept between records.
+ *
+ */
+
+template <class T>
+class JsonLinesWriter {
+public:
+    enum {
+        BufferSize = 64 * 1024,
+    };
+
+    explicit JsonLinesWriter(QIODevice *device);
+    ~JsonLinesWriter();
+
+    /* Returns false if the record can't be written or the device fails */
+    bool write(const T &record);
+
+    /* Write the remaining buffer to device, returns false if the device fails */
+    bool flush();
+    bool hasError() const;
+
+private:
+    QIODevice *q_device;
+    QByteArray q_buf;
+    bool q_error;
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+template <class T>
+JsonLinesReader<T>::JsonLinesReader(QIODevice *device)
+    : q_device(device), q_pos(0), q_scanned(0), q_eof(false), q_line(0), q_pool(nullptr), q_batchSize(BatchSize),
+      q_next(0), q_status(JsonStream::Ok), q_lineNumber(0) {
+    q_buf.reserve(BufferSize);
+    q_batch.reserve(BufferSize);
+}
+
+template <class T>
+void JsonLinesReader<T>::setThreadPool(QThreadPool *pool, int batchSize) {
+    q_pool = pool;
+    q_batchSize = qMax(1, batchSize);
+}
+
+template <class T>
+bool JsonLinesReader<T>::readNext(T *out) {
+    if (!q_pool && q_next == q_records.size()) {
+        const char *line;
+        int size;
+        if (!nextLine(&line, &size)) {
+            q_status = JsonStream::Ok;
+            return false;
+        }
+        q_lineNumber = q_line;
+        q_status = parse(line, size, q_line, out);
+        return q_status == JsonStream::Ok;
+    }
+
+    if (q_next == q_records.size() && !fillBatch()) {
+        q_status = JsonStream::Ok;
+        return false;
+    }
+
+    // Swapped, the caller's old record is reused by a later batch
+    const Record &rec = q_records.at(q_next);
+    q_lineNumber = rec.line;
+    q_status = rec.status;
+    std::swap(*out, q_values[q_next]);
+    q_next++;
+    return q_status == JsonStream::Ok;
+}
+
+template <class T>
+bool JsonLinesReader<T>::atEnd() {
+    if (q_next < q_records.size()) {
+        return false;
+    }
+    while (true) {
+        const int end = q_buf.size();
+        const char *data = q_buf.constData();
+        for (int i = q_pos; i < end; ++i) {
+            const char c = data[i];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                return false;
+            }
+        }
+        if (q_eof) {
+            return true;
+        }
+
+        // Only blank lines are left in the buffer
+        q_line += std::count(data + q_pos, data + end, '\n');
+        q_buf.resize(0);
+        q_pos = 0;
+        q_scanned = 0;
+
+        q_buf.resize(BufferSize);
+        qint64 n = q_device->read(q_buf.data(), BufferSize);
+        q_buf.resize(int(qMax<qint64>(0, n)));
+        if (n <= 0) {
+            q_eof = true;
+        }
+    }
+}
+
+template <class T>
+bool JsonLinesReader<T>::nextLine(const char **line, int *size) {
+    while (true) {
+        const char *data = q_buf.constData();
+        const char *begin = data + q_pos;
+        const char *end = data + q_buf.size();
+        const char *nl = static_cast<const char *>(memchr(begin + q_scanned, '\n', end - begin - q_scanned));
+        if (!nl && !q_eof) {
+            // Move the incomplete line to the front, a long line grows the buffer
+            q_scanned = int(end - begin);
+            q_buf.remove(0, q_pos);
+            q_pos = 0;
+
+            const int used = q_buf.size();
+            q_buf.resize(used + BufferSize);
+            qint64 n = q_device->read(q_buf.data() + used, BufferSize);
+            q_buf.resize(used + int(qMax<qint64>(0, n)));
+            if (n <= 0) {
+                q_eof = true;
+            }
+            continue;
+        }
+        if (begin == end) {
+            return false;
+        }
+
+        const char *stop = nl ? nl : end;
+        q_pos = int((nl ? nl + 1 : end) - data);
+        q_scanned = 0;
+        q_line++;
+
+        // Trailing "\r" is a space for the json reader
+        const char *p = begin;
+        while (p < stop && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p == stop) {
+            continue;
+        }
+        *line = begin;
+        *size = int(stop - begin);
+        return true;
+    }
+}
+
+template <class T>
+bool JsonLinesReader<T>::fillBatch() {
+    q_batch.resize(0);
+    q_records.resize(0);
+    q_next = 0;
+
+    const char *line;
+    int size;
+    while (q_records.size() < q_batchSize && q_batch.size() < BatchBytes && nextLine(&line, &size)) {
+        Record rec = {q_batch.size(), size, q_line, JsonStream::Ok};
+        q_records.append(rec);
+        q_batch.append(line, size);
+    }
+    if (q_records.isEmpty()) {
+        return false;
+    }
+    if (q_values.size() < q_records.size()) {
+        q_values.resize(q_records.size());
+    }
+
+    const char *data = q_batch.constData();
+    Record *records = q_records.data();
+    T *values = q_values.data();
+    auto decode = [data, records, values](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Record &rec = records[i];
+            rec.status = parse(data + rec.offset, rec.size, rec.line, &values[i]);
+        }
+    };
+
+    const int threads = q_pool ? q_pool->maxThreadCount() : 1;
+    const int chunk = qMax(1, q_records.size() / (4 * qMax(1, threads)));
+    JsonStreamPrivate::runParallel(q_pool, q_records.size(), chunk, decode);
+    return true;
+}
+
+template <class T>
+JsonStream::Status JsonLinesReader<T>::parse(const char *line, int size, qint64 lineNumber, T *out) {
+    JsonReader reader(line, size);
+    reader.setInPlace(true);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        reader.setStatus(JsonStream::SyntaxError);
+    }
+    if (!reader.good()) {
+        qAsDbg() << "QAS::JsonLinesReader: bad record at line " << lineNumber;
+    }
+    return reader.status();
+}
+
+template <class T>
+JsonLinesWriter<T>::JsonLinesWriter(QIODevice *device) : q_device(device), q_error(false) {
+    q_buf.reserve(BufferSize);
+}
+
+template <class T>
+JsonLinesWriter<T>::~JsonLinesWriter() {
+    flush();
+}
+
+template <class T>
+bool JsonLinesWriter<T>::write(const T &record) {
+    // A record that fails is dropped from the buffer
+    const int size = q_buf.size();
+    {
+        JsonWriter writer(&q_buf, JsonWriter::Compact);
+        writer << record;
+        if (writer.hasError()) {
+            q_buf.resize(size);
+            q_error = true;
+            return false;
+        }
+    }
+    q_buf.append('\n');
+    if (q_buf.size() >= BufferSize) {
+        return flush();
+    }
+    return !q_error;
+}
+
+template <class T>
+bool JsonLinesWriter<T>::flush() {
+    if (q_buf.isEmpty()) {
+        return !q_error;
+    }
+    if (q_device->write(q_buf) != q_buf.size()) {
+        q_error = true;
+    }
+    q_buf.resize(0);
+    return !q_error;
+}
+
+template <class T>
+bool JsonLinesWriter<T>::hasError() const {
+    return q_error;
+}
+
+QAS_END_NAMESPACE
+
+#endif // QASJSONLINES_H
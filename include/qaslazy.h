@@ -0,0 +1,303 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QASLAZY_H
+#define QASLAZY_H
+
+#include "qcborreader.h"
+#include "qcborwriter.h"
+#include "qjsonreader.h"
+#include "qjsonwriter.h"
+#include "qjsonstream.h"
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * Lazy keeps the undecoded json text, CBOR item or json value of a member and converts it on
+ * the first access, a large member which is rarely used costs only a skip and a copy when the
+ * owner is read.
+ *
+ * A member never accessed is written back as it was read if the format is the same. Accessing
+ * it through a non-const function drops the source since the value may change.
+ *
+ * The first access isn't thread safe even if it's const.
+ *
+ */
+
+template <class T>
+class Lazy {
+public:
+    enum Source {
+        None,
+        Json,
+        Cbor,
+        Value,
+    };
+
+    Lazy();
+    Lazy(const T &value);
+    Lazy(T &&value);
+
+    Lazy &operator=(const T &value);
+    Lazy &operator=(T &&value);
+
+    /* Converts on the first access, a failure keeps the default value and sets status() */
+    const T &get() const;
+    T &get();
+
+    inline const T *operator->() const {
+        return &get();
+    }
+
+    inline T *operator->() {
+        return &get();
+    }
+
+    inline const T &operator*() const {
+        return get();
+    }
+
+    inline T &operator*() {
+        return get();
+    }
+
+    inline bool isLoaded() const {
+        return q_loaded;
+    }
+
+    /* Status of the conversion, Ok before the first access */
+    inline JsonStream::Status status() const {
+        return q_status;
+    }
+
+    inline Source source() const {
+        return q_source;
+    }
+
+    inline const QByteArray &raw() const {
+        return q_raw;
+    }
+
+    inline const QJsonValue &value() const {
+        return q_value;
+    }
+
+    void setRaw(Source source, const QByteArray &raw);
+    void setValue(const QJsonValue &value);
+
+private:
+    mutable T q_data;
+    mutable bool q_loaded;
+    mutable JsonStream::Status q_status;
+
+    Source q_source;
+    QByteArray q_raw;
+    QJsonValue q_value;
+
+    void load() const;
+    void reset();
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+template <class T>
+Lazy<T>::Lazy() : q_data{}, q_loaded(true), q_status(JsonStream::Ok), q_source(None) {
+}
+
+template <class T>
+Lazy<T>::Lazy(const T &value) : q_data(value), q_loaded(true), q_status(JsonStream::Ok), q_source(None) {
+}
+
+template <class T>
+Lazy<T>::Lazy(T &&value) : q_data(std::move(value)), q_loaded(true), q_status(JsonStream::Ok), q_source(None) {
+}
+
+template <class T>
+Lazy<T> &Lazy<T>::operator=(const T &value) {
+    reset();
+    q_data = value;
+    return *this;
+}
+
+template <class T>
+Lazy<T> &Lazy<T>::operator=(T &&value) {
+    reset();
+    q_data = std::move(value);
+    return *this;
+}
+
+template <class T>
+const T &Lazy<T>::get() const {
+    load();
+    return q_data;
+}
+
+template <class T>
+T &Lazy<T>::get() {
+    load();
+    q_source = None;
+    q_raw.clear();
+    q_value = QJsonValue();
+    return q_data;
+}
+
+template <class T>
+void Lazy<T>::setRaw(Source source, const QByteArray &raw) {
+    reset();
+    q_data = T{};
+    q_loaded = false;
+    q_source = source;
+    q_raw = raw;
+}
+
+template <class T>
+void Lazy<T>::setValue(const QJsonValue &value) {
+    reset();
+    q_data = T{};
+    q_loaded = false;
+    q_source = Value;
+    q_value = value;
+}
+
+template <class T>
+void Lazy<T>::load() const {
+    if (q_loaded) {
+        return;
+    }
+    q_loaded = true;
+
+    switch (q_source) {
+        case Json: {
+            JsonReader reader(q_raw);
+            reader >> q_data;
+            q_status = reader.status();
+            break;
+        }
+        case Cbor: {
+            CborReader reader(q_raw);
+            reader >> q_data;
+            q_status = reader.status();
+            break;
+        }
+        case Value: {
+            JsonStream stream(q_value);
+            stream >> q_data;
+            q_status = stream.status();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+template <class T>
+void Lazy<T>::reset() {
+    q_loaded = true;
+    q_status = JsonStream::Ok;
+    q_source = None;
+    q_raw.clear();
+    q_value = QJsonValue();
+}
+
+// ----------------------------------
+// Operators
+// ----------------------------------
+
+template <class T>
+JsonStream &operator>>(JsonStream &stream, Lazy<T> &var) {
+    stream.resetStatus();
+    var.setValue(stream.data());
+    return stream;
+}
+
+template <class T>
+JsonStream &operator<<(JsonStream &stream, const Lazy<T> &var) {
+    QJsonValue value;
+    switch (var.source()) {
+        case Lazy<T>::Json:
+            JsonReader(var.raw()).readValue(&value);
+            return stream << value;
+        case Lazy<T>::Cbor:
+            CborReader(var.raw()).readValue(&value);
+            return stream << value;
+        case Lazy<T>::Value:
+            return stream << var.value();
+        default:
+            break;
+    }
+    return stream << var.get();
+}
+
+template <class T>
+JsonReader &operator>>(JsonReader &reader, Lazy<T> &var) {
+    // Nothing is kept, but the content must be checked now
+    if (reader.validateOnly()) {
+        T tmp{};
+        return reader >> tmp;
+    }
+
+    QByteArray raw;
+    if (reader.readRaw(&raw)) {
+        var.setRaw(Lazy<T>::Json, raw);
+    }
+    return reader;
+}
+
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const Lazy<T> &var) {
+    if (var.source() == Lazy<T>::Json) {
+        writer.writeRaw(var.raw().constData(), var.raw().size());
+        return writer;
+    }
+    if (var.source() == Lazy<T>::Value) {
+        writer.writeValue(var.value());
+        return writer;
+    }
+    return writer << var.get();
+}
+
+template <class T>
+CborReader &operator>>(CborReader &reader, Lazy<T> &var) {
+    // Nothing is kept, but the content must be checked now
+    if (reader.validateOnly()) {
+        T tmp{};
+        return reader >> tmp;
+    }
+
+    QByteArray raw;
+    if (reader.readRaw(&raw)) {
+        var.setRaw(Lazy<T>::Cbor, raw);
+    }
+    return reader;
+}
+
+// QCborStreamWriter counts the items of containers itself, encoded items can't be copied into it
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const Lazy<T> &var) {
+    if (var.source() == Lazy<T>::Value) {
+        writer.writeValue(var.value());
+        return writer;
+    }
+    return writer << var.get();
+}
+
+QAS_END_NAMESPACE
+
+#endif // QASLAZY_H
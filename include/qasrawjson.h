@@ -0,0 +1,193 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QASRAWJSON_H
+#define QASRAWJSON_H
+
+#include "qcborreader.h"
+#include "qcborwriter.h"
+#include "qjsonreader.h"
+#include "qjsonwriter.h"
+#include "qjsonstream.h"
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * RawJson holds an opaque member of any json type which is never inspected, the streaming
+ * readers only copy its bytes and the json writer copies them back, no DOM is built unless
+ * toValue() is called.
+ *
+ * The CBOR writer still decodes and re-encodes the bytes, see the Lazy writer.
+ *
+ * A default constructed RawJson is an empty object.
+ *
+ */
+
+class RawJson {
+public:
+    enum Format {
+        Json,
+        Cbor,
+        Value,
+    };
+
+    inline RawJson() : q_format(Value), q_value(QJsonObject()) {
+    }
+
+    inline RawJson(const QJsonValue &value) : q_format(Value), q_value(value) {
+    }
+
+    static inline RawJson fromJson(const QByteArray &json) {
+        return RawJson(Json, json);
+    }
+
+    static inline RawJson fromCbor(const QByteArray &cbor) {
+        return RawJson(Cbor, cbor);
+    }
+
+    inline Format format() const {
+        return q_format;
+    }
+
+    /* Bytes as they were read, empty if the format is Value */
+    inline const QByteArray &raw() const {
+        return q_raw;
+    }
+
+    /* Parses the bytes, Undefined if they are broken */
+    QJsonValue toValue() const;
+
+private:
+    inline RawJson(Format format, const QByteArray &raw) : q_format(format), q_raw(raw) {
+    }
+
+    Format q_format;
+    QByteArray q_raw;
+    QJsonValue q_value;
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+inline QJsonValue RawJson::toValue() const {
+    QJsonValue value(QJsonValue::Undefined);
+    switch (q_format) {
+        case Json:
+            JsonReader(q_raw).readValue(&value);
+            break;
+        case Cbor:
+            CborReader(q_raw).readValue(&value);
+            break;
+        default:
+            value = q_value;
+            break;
+    }
+    return value;
+}
+
+// ----------------------------------
+// Operators
+// ----------------------------------
+
+inline JsonStream &operator>>(JsonStream &stream, RawJson &var) {
+    stream.resetStatus();
+    var = stream.data();
+    return stream;
+}
+
+inline JsonStream &operator<<(JsonStream &stream, const RawJson &var) {
+    return stream << var.toValue();
+}
+
+namespace JsonStreamPrivate {
+
+    // Empty objects and arrays are the most common opaque members, they are kept as values without a copy
+    inline bool emptyJson(Utf8View raw, QJsonValue *out) {
+        if (raw.size() < 2) {
+            return false;
+        }
+        const char first = raw.data()[0];
+        const char last = raw.data()[raw.size() - 1];
+        if (!(first == '{' && last == '}') && !(first == '[' && last == ']')) {
+            return false;
+        }
+        for (int i = 1; i < raw.size() - 1; ++i) {
+            const char c = raw.data()[i];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                return false;
+            }
+        }
+        *out = first == '{' ? QJsonValue(QJsonObject()) : QJsonValue(QJsonArray());
+        return true;
+    }
+
+    inline bool emptyCbor(const char *data, int size, QJsonValue *out) {
+        // Definite length, or indefinite length with a break
+        const uchar first = uchar(size > 0 ? data[0] : 0);
+        if (size == 1 && (first == 0xa0 || first == 0x80)) {
+            *out = first == 0xa0 ? QJsonValue(QJsonObject()) : QJsonValue(QJsonArray());
+            return true;
+        }
+        if (size == 2 && uchar(data[1]) == 0xff && (first == 0xbf || first == 0x9f)) {
+            *out = first == 0xbf ? QJsonValue(QJsonObject()) : QJsonValue(QJsonArray());
+            return true;
+        }
+        return false;
+    }
+
+}
+
+inline JsonReader &operator>>(JsonReader &reader, RawJson &var) {
+    Utf8View raw;
+    if (reader.readRaw(&raw) && !reader.validateOnly()) {
+        QJsonValue value;
+        var = JsonStreamPrivate::emptyJson(raw, &value) ? RawJson(value)
+                                                        : RawJson::fromJson(QByteArray(raw.data(), raw.size()));
+    }
+    return reader;
+}
+
+inline JsonWriter &operator<<(JsonWriter &writer, const RawJson &var) {
+    if (var.format() == RawJson::Json) {
+        writer.writeRaw(var.raw().constData(), var.raw().size());
+        return writer;
+    }
+    writer.writeValue(var.toValue());
+    return writer;
+}
+
+inline CborReader &operator>>(CborReader &reader, RawJson &var) {
+    const char *data = nullptr;
+    int size = 0;
+    if (reader.readRaw(&data, &size) && !reader.validateOnly()) {
+        QJsonValue value;
+        var = JsonStreamPrivate::emptyCbor(data, size, &value) ? RawJson(value)
+                                                               : RawJson::fromCbor(QByteArray(data, size));
+    }
+    return reader;
+}
+
+inline CborWriter &operator<<(CborWriter &writer, const RawJson &var) {
+    writer.writeValue(var.toValue());
+    return writer;
+}
+
+QAS_END_NAMESPACE
+
+#endif // QASRAWJSON_H
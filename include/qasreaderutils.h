@@ -0,0 +1,291 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QASREADERUTILS_H
+#define QASREADERUTILS_H
+
+#include "qjsonstream.h"
+
+#include <QFile>
+#include <QSharedPointer>
+#include <QVarLengthArray>
+
+#include <atomic>
+
+QAS_BEGIN_NAMESPACE
+
+// ----------------------------------
+// Private Part
+// ----------------------------------
+
+// Helpers shared by JsonReader and CborReader, READER is either of them
+
+namespace ReaderUtils {
+
+    // Maps the whole file, or reads it if it can't be mapped like a pipe or a compressed resource, the data is
+    // valid while the file is open
+    inline void mapFile(QFile &file, QByteArray *buf, const char **data, qint64 *size) {
+        const qint64 fileSize = file.size();
+        uchar *map = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+        if (map) {
+            *data = reinterpret_cast<const char *>(map);
+            *size = fileSize;
+            return;
+        }
+        *buf = file.readAll();
+        *data = buf->constData();
+        *size = buf->size();
+    }
+
+    // Concrete class of a polymorphic pointer, selected by the value of its type member
+    template <class DERIVED, class TYPE>
+    struct DerivedClass {
+        TYPE type;
+    };
+
+    template <class DERIVED, class TYPE>
+    DerivedClass<DERIVED, TYPE> derivedClass(TYPE type) {
+        return {type};
+    }
+
+    template <class READER, class BASE, class TYPE>
+    READER &parseDerived(READER &reader, QSharedPointer<BASE> &var, TYPE BASE::*member, TYPE type) {
+        Q_UNUSED(var);
+        Q_UNUSED(member);
+        Q_UNUSED(type);
+        return reader;
+    }
+
+    // Reads the class matching type, the pointer is reused in place mode if it holds the same class
+    template <class READER, class BASE, class TYPE, class DERIVED, class... CLASSES>
+    READER &parseDerived(READER &reader, QSharedPointer<BASE> &var, TYPE BASE::*member, TYPE type,
+                         DerivedClass<DERIVED, TYPE> cls, CLASSES... classes) {
+        if (cls.type != type) {
+            return parseDerived(reader, var, member, type, classes...);
+        }
+        if (reader.validateOnly()) {
+            DERIVED tmpVar;
+            return reader >> tmpVar;
+        }
+        if (reader.inPlace() && var && (*var).*member == type) {
+            return reader >> *var.template staticCast<DERIVED>();
+        }
+        auto realVar = QSharedPointer<DERIVED>::create();
+        var = realVar;
+        return reader >> *realVar;
+    }
+
+}
+
+// ----------------------------------
+// Supported Containers
+// ----------------------------------
+
+namespace ReaderContainers {
+
+    using JsonStreamContainers::append;
+    using JsonStreamContainers::reserve;
+
+    // Elements of sets are immutable, they can only be inserted again
+    template <class LIST>
+    struct IsUpdatable {
+        static const bool value =
+                !std::is_const<typename std::remove_reference<decltype(*std::declval<LIST &>().begin())>::type>::value;
+    };
+
+    // In place list, read over the existing elements, append the rest and erase the surplus
+    template <class READER, class LIST>
+    READER &updateList(READER &reader, LIST &list, std::true_type) {
+        auto it = list.begin();
+        bool tail = false; // Iterators are invalid after appending
+        int index = 0;
+        while (reader.nextElement()) {
+            if (!tail && it == list.end()) {
+                tail = true;
+            }
+            if (tail) {
+                typename LIST::value_type tmp{};
+                reader >> tmp;
+                if (reader.good()) {
+                    append(list, std::move(tmp));
+                }
+            } else {
+                reader >> *it;
+                ++it;
+            }
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
+                return reader;
+            }
+            ++index;
+        }
+        if (reader.good() && !tail) {
+            list.erase(it, list.end());
+        }
+        return reader;
+    }
+
+    // In place set, keep the storage and insert again
+    template <class READER, class LIST>
+    READER &updateList(READER &reader, LIST &list, std::false_type) {
+        list.clear();
+        int index = 0;
+        while (reader.nextElement()) {
+            typename LIST::value_type tmp{};
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
+                return reader;
+            }
+
+            append(list, std::move(tmp));
+            ++index;
+        }
+        return reader;
+    }
+
+    // In place map, read into the existing values and erase the keys absent from the input
+    template <class READER, class MAP, class OP>
+    READER &updateMap(READER &reader, MAP &map, OP op) {
+        QSet<QString> names;
+
+        Utf8View key;
+        while (reader.nextMember(&key)) {
+            // Keys are only valid until next member
+            QString name = QString::fromUtf8(key.data(), key.size());
+
+            reader >> map[name];
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(map) << ": fail at key " << name;
+                return reader;
+            }
+            names.insert(name);
+        }
+        if (!reader.good() || size_t(names.size()) == size_t(map.size())) {
+            return reader;
+        }
+        for (auto it = map.begin(); it != map.end();) {
+            if (names.contains(op.key(it))) {
+                ++it;
+            } else {
+                it = map.erase(it);
+            }
+        }
+        return reader;
+    }
+
+    // Validate only, every element is read into the same temporary and dropped
+    template <class READER, class LIST>
+    READER &checkList(READER &reader, LIST &list) {
+        typename LIST::value_type tmp{};
+        int index = 0;
+        while (reader.nextElement()) {
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
+                return reader;
+            }
+            ++index;
+        }
+        return reader;
+    }
+
+    template <class READER, class MAP>
+    READER &checkMap(READER &reader, MAP &map) {
+        typename MAP::mapped_type tmp{};
+        QVarLengthArray<char, 64> name; // Keys are only valid until the value is read
+
+        Utf8View key;
+        while (reader.nextMember(&key)) {
+            name.resize(key.size());
+            memcpy(name.data(), key.data(), key.size());
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(map) << ": fail at key " << QString::fromUtf8(name.constData(), name.size());
+                return reader;
+            }
+        }
+        return reader;
+    }
+
+    // The remaining elements are located with skipValue() and decoded on the pool into pre-sized storage,
+    // elements after a failed one are skipped so the lowest failing index is reported as by a sequential read
+    template <class READER, class LIST>
+    READER &writeParallel(READER &reader, LIST &list, LIST &tmpList, int index) {
+        typedef typename LIST::value_type T;
+
+        std::vector<qint64> ranges; // Begin and end of each element
+        do {
+            const qint64 begin = reader.position();
+            if (!reader.skipValue()) {
+                break;
+            }
+            ranges.push_back(begin);
+            ranges.push_back(reader.position());
+        } while (reader.nextElement());
+
+        const int count = int(ranges.size() / 2);
+        std::unique_ptr<T[]> values(new T[count]());
+        std::vector<JsonStream::Status> status(count, JsonStream::Ok);
+        std::atomic<int> failed(count);
+
+        // The pool is busy with this list, the lists of the elements are read on their thread
+        auto decode = [&](int begin, int end) {
+            for (int i = begin; i < end && i < failed.load(std::memory_order_relaxed); ++i) {
+                READER elementReader = reader.slice(ranges[2 * i], ranges[2 * i + 1]);
+                elementReader.setThreadPool(nullptr);
+                elementReader >> values[i];
+                if (!elementReader.good()) {
+                    status[i] = elementReader.status();
+                    int cur = failed.load();
+                    while (i < cur && !failed.compare_exchange_weak(cur, i)) {
+                    }
+                    return;
+                }
+            }
+        };
+        const int threads = qMax(1, reader.threadPool()->maxThreadCount());
+        JsonStreamPrivate::runParallel(reader.threadPool(), count, qMax(1, count / (4 * threads)), decode);
+
+        const int first = failed.load();
+        if (first < count) {
+            qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index + first;
+            reader.resetStatus();
+            reader.setStatus(status[first]);
+            return reader;
+        }
+        if (!reader.good()) {
+            qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index + count;
+            return reader;
+        }
+
+        reserve(tmpList, index + count);
+        for (int i = 0; i < count; ++i) {
+            append(tmpList, std::move(values[i]));
+        }
+        list = std::move(tmpList);
+        return reader;
+    }
+
+}
+
+QAS_END_NAMESPACE
+
+#endif // QASREADERUTILS_H
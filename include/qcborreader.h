@@ -0,0 +1,1476 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QCBORREADER_H
+#define QCBORREADER_H
+
+#include "qasreaderutils.h"
+#include "qjsonstream.h"
+
+#include <QFile>
+#include <QSharedPointer>
+#include <QVarLengthArray>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * CborReader is a pull parser over CBOR (RFC 8949) data with the interface of JsonReader, the
+ * generated deserializers use it in the same way.
+ *
+ * QCborStreamReader can't go back to a saved position, which is needed to read base classes
+ * and polymorphic types, so the data is parsed here directly. Maps are called objects and only
+ * text keys are accepted.
+ *
+ */
+
+class CborReader {
+public:
+    enum {
+        MaxDepth = 1024,
+        ParallelThreshold = 32,
+    };
+
+    enum Type {
+        Invalid,
+        UnsignedInteger,
+        NegativeInteger,
+        ByteString,
+        TextString,
+        Array,
+        Map,
+        Tag,
+        Bool,
+        Null,
+        Float,
+    };
+
+    explicit CborReader(const QByteArray &data);
+    CborReader(const char *data, qint64 size);
+    ~CborReader() = default;
+
+    JsonStream::Status status() const;
+    void setStatus(JsonStream::Status status);
+    void resetStatus();
+
+    inline bool failed() const {
+        return q_status & JsonStream::Failed;
+    }
+
+    inline bool good() const {
+        return q_status & JsonStream::Success;
+    }
+
+    /* Read into existing values reusing their storage, a failed read leaves them partially updated */
+    inline bool inPlace() const {
+        return q_inPlace;
+    }
+
+    inline void setInPlace(bool inPlace) {
+        q_inPlace = inPlace;
+    }
+
+    /* Only check the input, values are read into temporaries and dropped, strings aren't decoded */
+    inline bool validateOnly() const {
+        return q_validateOnly;
+    }
+
+    inline void setValidateOnly(bool validateOnly) {
+        q_validateOnly = validateOnly;
+    }
+
+    /* Decode the elements of lists on the pool after the first threshold ones, nullptr reads on the calling thread */
+    inline QThreadPool *threadPool() const {
+        return q_pool;
+    }
+
+    inline int parallelThreshold() const {
+        return q_parallelThreshold;
+    }
+
+    inline void setThreadPool(QThreadPool *pool, int threshold = ParallelThreshold) {
+        q_pool = pool;
+        q_parallelThreshold = qMax(0, threshold);
+    }
+
+    /* Members to read, set by the generated readers while they descend, see FieldMask */
+    inline const FieldMask::Cursor &mask() const {
+        return q_mask;
+    }
+
+    inline void setMask(const FieldMask::Cursor &mask) {
+        q_mask = mask;
+    }
+
+    /* Offset of the next item, seek() back only between complete values */
+    qint64 position() const;
+    void seek(qint64 pos);
+
+    /* Size of the input */
+    qint64 size() const;
+
+    /* Reader of the complete value in [begin, end) of the input with the same options */
+    CborReader slice(qint64 begin, qint64 end) const;
+
+    bool atEnd() const;
+
+    /* Type of the next item, returns Invalid at the end of a container */
+    Type peek() const;
+
+    bool beginObject();
+    bool nextMember(Utf8View *key);
+    bool beginArray();
+    bool nextElement();
+
+    bool readString(QString *out);
+    bool readString(Utf8View *out);  // UTF-8 view, valid until the next read
+    bool readBytes(QByteArray *out); // Not copied if possible, valid while the data is alive
+    bool readTag(quint64 *out);
+    bool readDouble(double *out);
+    bool readInteger(qint64 *out);
+    bool readUnsigned(quint64 *out);
+    bool readBool(bool *out);
+    bool readNull();
+    bool readValue(QJsonValue *out);
+    bool readRaw(QByteArray *out);              // Encoded bytes of the next item including tags, copied
+    bool readRaw(const char **data, int *size); // Encoded bytes of the next item including tags, a view into the input
+    bool skipValue();
+
+public:
+    CborReader &operator>>(qint8 &sc);
+    CborReader &operator>>(quint8 &c);
+    CborReader &operator>>(qint16 &s);
+    CborReader &operator>>(quint16 &us);
+    CborReader &operator>>(qint32 &i);
+    CborReader &operator>>(quint32 &u);
+    CborReader &operator>>(qint64 &l);
+    CborReader &operator>>(quint64 &ul);
+    CborReader &operator>>(bool &b);
+    CborReader &operator>>(float &f);
+    CborReader &operator>>(double &d);
+    CborReader &operator>>(QString &s);
+    CborReader &operator>>(QJsonValue &val);
+    CborReader &operator>>(QJsonArray &arr);
+    CborReader &operator>>(QJsonObject &obj);
+
+private:
+    QByteArray q_data;
+    const char *q_begin;
+    const char *q_end;
+    const char *q_ptr;
+
+    QByteArray q_buf;                     // Chunked string
+    QVarLengthArray<qint64, 32> q_frames; // Items left in containers, -1 if indefinite
+    bool q_inPlace;
+    bool q_validateOnly;
+    QThreadPool *q_pool;
+    int q_parallelThreshold;
+    FieldMask::Cursor q_mask;
+    JsonStream::Status q_status;
+
+    bool fail(JsonStream::Status status);
+    bool expect(Type type);
+    bool readHead(int *major, quint64 *arg, bool *indefinite);
+    bool readChunks(const char **str, qint64 *len);
+    bool checkSize(qint64 len);
+    bool outOfRange();
+    bool next();
+    bool skipItem(int depth);
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+inline CborReader::CborReader(const QByteArray &data) : CborReader(data.constData(), data.size()) {
+    q_data = data;
+}
+
+inline CborReader::CborReader(const char *data, qint64 size)
+    : q_begin(data), q_end(data + size), q_ptr(data), q_inPlace(false), q_validateOnly(false), q_pool(nullptr),
+      q_parallelThreshold(ParallelThreshold), q_status(JsonStream::Ok) {
+}
+
+inline JsonStream::Status CborReader::status() const {
+    return q_status;
+}
+
+inline void CborReader::setStatus(JsonStream::Status status) {
+    if (q_status == JsonStream::Ok)
+        q_status = status;
+}
+
+inline void CborReader::resetStatus() {
+    q_status = JsonStream::Ok;
+}
+
+inline qint64 CborReader::position() const {
+    return q_ptr - q_begin;
+}
+
+inline qint64 CborReader::size() const {
+    return q_end - q_begin;
+}
+
+inline void CborReader::seek(qint64 pos) {
+    q_ptr = q_begin + qBound(qint64(0), pos, qint64(q_end - q_begin));
+}
+
+inline CborReader CborReader::slice(qint64 begin, qint64 end) const {
+    CborReader reader(q_begin + begin, end - begin);
+    reader.q_inPlace = q_inPlace;
+    reader.q_validateOnly = q_validateOnly;
+    reader.q_pool = q_pool;
+    reader.q_parallelThreshold = q_parallelThreshold;
+    reader.q_mask = q_mask;
+    return reader;
+}
+
+inline bool CborReader::atEnd() const {
+    return q_ptr == q_end;
+}
+
+inline CborReader::Type CborReader::peek() const {
+    if (q_ptr == q_end) {
+        return Invalid;
+    }
+    uchar ib = uchar(*q_ptr);
+    switch (ib >> 5) {
+        case 0:
+            return UnsignedInteger;
+        case 1:
+            return NegativeInteger;
+        case 2:
+            return ByteString;
+        case 3:
+            return TextString;
+        case 4:
+            return Array;
+        case 5:
+            return Map;
+        case 6:
+            return Tag;
+        default:
+            break;
+    }
+    switch (ib & 0x1F) {
+        case 20:
+        case 21:
+            return Bool;
+        case 22:
+        case 23:
+            return Null;
+        case 25:
+        case 26:
+        case 27:
+            return Float;
+        default:
+            break;
+    }
+    return Invalid;
+}
+
+inline bool CborReader::beginObject() {
+    if (!expect(Map)) {
+        return false;
+    }
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+    // Each pair takes at least 2 bytes
+    if (!indefinite && arg > quint64(q_end - q_ptr) / 2) {
+        return fail(JsonStream::SyntaxError);
+    }
+    if (q_frames.size() >= MaxDepth) {
+        return fail(JsonStream::SyntaxError);
+    }
+    q_frames.append(indefinite ? -1 : qint64(arg));
+    return true;
+}
+
+inline bool CborReader::nextMember(Utf8View *key) {
+    if (!next()) {
+        return false;
+    }
+    if (peek() != TextString) {
+        return fail(JsonStream::SyntaxError);
+    }
+    return readString(key);
+}
+
+inline bool CborReader::beginArray() {
+    if (!expect(Array)) {
+        return false;
+    }
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+    if (!indefinite && arg > quint64(q_end - q_ptr)) {
+        return fail(JsonStream::SyntaxError);
+    }
+    if (q_frames.size() >= MaxDepth) {
+        return fail(JsonStream::SyntaxError);
+    }
+    q_frames.append(indefinite ? -1 : qint64(arg));
+    return true;
+}
+
+inline bool CborReader::nextElement() {
+    return next();
+}
+
+inline bool CborReader::readString(QString *out) {
+    const char *str = nullptr;
+    qint64 len = 0;
+    if (!expect(TextString) || !readChunks(&str, &len) || !checkSize(len)) {
+        return false;
+    }
+    JsonStreamPrivate::assignUtf8(out, str, len, q_inPlace);
+    return true;
+}
+
+inline bool CborReader::readString(Utf8View *out) {
+    const char *str = nullptr;
+    qint64 len = 0;
+    if (!expect(TextString) || !readChunks(&str, &len) || !checkSize(len)) {
+        return false;
+    }
+    *out = Utf8View(str, int(len));
+    return true;
+}
+
+inline bool CborReader::readBytes(QByteArray *out) {
+    const char *str = nullptr;
+    qint64 len = 0;
+    if (!expect(ByteString) || !readChunks(&str, &len) || !checkSize(len)) {
+        return false;
+    }
+    if (str == q_buf.constData()) {
+        *out = q_buf;
+    } else {
+        *out = QByteArray::fromRawData(str, int(len));
+    }
+    return true;
+}
+
+inline bool CborReader::readTag(quint64 *out) {
+    int major = 0;
+    bool indefinite = false;
+    return expect(Tag) && readHead(&major, out, &indefinite);
+}
+
+inline bool CborReader::readDouble(double *out) {
+    Type type = peek();
+    if (type != UnsignedInteger && type != NegativeInteger && type != Float) {
+        return fail(type == Invalid ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    int info = uchar(*q_ptr) & 0x1F;
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+    if (type == UnsignedInteger) {
+        *out = double(arg);
+    } else if (type == NegativeInteger) {
+        *out = -1.0 - double(arg);
+    } else if (info == 27) {
+        memcpy(out, &arg, sizeof(double));
+    } else if (info == 26) {
+        quint32 bits = quint32(arg);
+        float f;
+        memcpy(&f, &bits, sizeof(float));
+        *out = f;
+    } else {
+        // Half precision, RFC 8949 Appendix D
+        int exp = int(arg >> 10) & 0x1F;
+        int mant = int(arg) & 0x3FF;
+        double val;
+        if (exp == 0) {
+            val = std::ldexp(mant, -24);
+        } else if (exp != 31) {
+            val = std::ldexp(mant + 1024, exp - 25);
+        } else {
+            val = mant == 0 ? INFINITY : NAN;
+        }
+        *out = (arg & 0x8000) ? -val : val;
+    }
+    return true;
+}
+
+inline bool CborReader::readInteger(qint64 *out) {
+    Type type = peek();
+    if (type == Float) {
+        double d = 0;
+        if (!readDouble(&d)) {
+            return false;
+        }
+        if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0)) {
+            return outOfRange();
+        }
+        *out = qint64(d);
+        return true;
+    }
+    if (type != UnsignedInteger && type != NegativeInteger) {
+        return fail(type == Invalid ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+    if (arg > quint64(std::numeric_limits<qint64>::max())) {
+        return outOfRange();
+    }
+    *out = type == UnsignedInteger ? qint64(arg) : -1 - qint64(arg);
+    return true;
+}
+
+inline bool CborReader::readUnsigned(quint64 *out) {
+    Type type = peek();
+    if (type == Float) {
+        // The same range as JsonReader, a float may be above the range of qint64
+        double d = 0;
+        if (!readDouble(&d)) {
+            return false;
+        }
+        if (!(d > -1.0 && d < 18446744073709551616.0)) {
+            return outOfRange();
+        }
+        *out = quint64(d);
+        return true;
+    }
+    if (type != UnsignedInteger) {
+        qint64 l = 0;
+        if (!readInteger(&l)) {
+            return false;
+        }
+        if (l < 0) {
+            return outOfRange();
+        }
+        *out = quint64(l);
+        return true;
+    }
+    int major = 0;
+    bool indefinite = false;
+    return readHead(&major, out, &indefinite);
+}
+
+inline bool CborReader::readBool(bool *out) {
+    if (!expect(Bool)) {
+        return false;
+    }
+    *out = (uchar(*q_ptr++) & 0x1F) == 21;
+    return true;
+}
+
+inline bool CborReader::readNull() {
+    if (!expect(Null)) {
+        return false;
+    }
+    ++q_ptr;
+    return true;
+}
+
+inline bool CborReader::readValue(QJsonValue *out) {
+    switch (peek()) {
+        case Map: {
+            QJsonObject obj;
+            Utf8View key;
+            beginObject();
+            while (nextMember(&key)) {
+                QString name = QString::fromUtf8(key.data(), key.size());
+                QJsonValue val;
+                if (!readValue(&val)) {
+                    return false;
+                }
+                obj.insert(name, val);
+            }
+            if (!good()) {
+                return false;
+            }
+            *out = obj;
+            break;
+        }
+        case Array: {
+            QJsonArray arr;
+            beginArray();
+            while (nextElement()) {
+                QJsonValue val;
+                if (!readValue(&val)) {
+                    return false;
+                }
+                arr.append(val);
+            }
+            if (!good()) {
+                return false;
+            }
+            *out = arr;
+            break;
+        }
+        case TextString: {
+            QString str;
+            if (!readString(&str)) {
+                return false;
+            }
+            *out = str;
+            break;
+        }
+        case UnsignedInteger:
+        case NegativeInteger:
+        case Float: {
+            double d = 0;
+            if (!readDouble(&d)) {
+                return false;
+            }
+            *out = d;
+            break;
+        }
+        case Bool: {
+            bool b = false;
+            if (!readBool(&b)) {
+                return false;
+            }
+            *out = b;
+            break;
+        }
+        case Null: {
+            if (!readNull()) {
+                return false;
+            }
+            *out = QJsonValue(QJsonValue::Null);
+            break;
+        }
+        case ByteString:
+        case Tag:
+            return fail(JsonStream::TypeNotMatch);
+        default:
+            return fail(JsonStream::SyntaxError);
+    }
+    return true;
+}
+
+inline bool CborReader::readRaw(QByteArray *out) {
+    const char *data = nullptr;
+    int size = 0;
+    if (!readRaw(&data, &size)) {
+        return false;
+    }
+    *out = QByteArray(data, size);
+    return true;
+}
+
+inline bool CborReader::readRaw(const char **data, int *size) {
+    const char *begin = q_ptr;
+    if (!skipValue() || !checkSize(q_ptr - begin)) {
+        return false;
+    }
+    *data = begin;
+    *size = int(q_ptr - begin);
+    return true;
+}
+
+inline bool CborReader::skipValue() {
+    return good() && skipItem(q_frames.size());
+}
+
+inline bool CborReader::fail(JsonStream::Status status) {
+    if (q_status == JsonStream::Ok && status == JsonStream::SyntaxError) {
+        qAsDbg() << "QAS::CborReader: invalid data at offset " << position();
+    }
+    setStatus(status);
+    return false;
+}
+
+inline bool CborReader::expect(Type type) {
+    if (!good()) {
+        return false;
+    }
+    Type cur = peek();
+    if (cur != type) {
+        return fail(cur == Invalid ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    return true;
+}
+
+inline bool CborReader::readHead(int *major, quint64 *arg, bool *indefinite) {
+    if (q_ptr == q_end) {
+        return fail(JsonStream::SyntaxError);
+    }
+    uchar ib = uchar(*q_ptr++);
+    int info = ib & 0x1F;
+    *major = ib >> 5;
+    *indefinite = false;
+    if (info < 24) {
+        *arg = quint64(info);
+        return true;
+    }
+    if (info == 31 && *major >= 2 && *major <= 5) {
+        *indefinite = true;
+        *arg = 0;
+        return true;
+    }
+    if (info > 27) {
+        return fail(JsonStream::SyntaxError);
+    }
+    int n = 1 << (info - 24);
+    if (q_end - q_ptr < n) {
+        return fail(JsonStream::SyntaxError);
+    }
+    quint64 val = 0;
+    for (int i = 0; i < n; ++i) {
+        val = (val << 8) | uchar(*q_ptr++);
+    }
+    *arg = val;
+    return true;
+}
+
+inline bool CborReader::readChunks(const char **str, qint64 *len) {
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+
+    // Fast path
+    if (!indefinite) {
+        if (arg > quint64(q_end - q_ptr)) {
+            return fail(JsonStream::SyntaxError);
+        }
+        *str = q_ptr;
+        *len = qint64(arg);
+        q_ptr += arg;
+        return true;
+    }
+
+    q_buf.resize(0);
+    while (true) {
+        if (q_ptr == q_end) {
+            return fail(JsonStream::SyntaxError);
+        }
+        if (uchar(*q_ptr) == 0xFF) {
+            ++q_ptr;
+            break;
+        }
+        int chunkMajor = 0;
+        if (!readHead(&chunkMajor, &arg, &indefinite)) {
+            return false;
+        }
+        if (chunkMajor != major || indefinite || arg > quint64(q_end - q_ptr)) {
+            return fail(JsonStream::SyntaxError);
+        }
+        if (!checkSize(q_buf.size() + qint64(arg))) {
+            return false;
+        }
+        q_buf.append(q_ptr, int(arg));
+        q_ptr += arg;
+    }
+    *str = q_buf.constData();
+    *len = q_buf.size();
+    return true;
+}
+
+inline bool CborReader::outOfRange() {
+    qAsDbg() << "QAS::CborReader: integer out of range at offset " << position();
+    return fail(JsonStream::TypeNotMatch);
+}
+
+inline bool CborReader::checkSize(qint64 len) {
+    if (len > JsonStreamPrivate::MaxSize) {
+        qAsDbg() << "QAS::CborReader: item of " << len << " bytes at offset " << position() << " is too large";
+        return fail(JsonStream::TypeNotMatch);
+    }
+    return true;
+}
+
+inline bool CborReader::next() {
+    if (!good()) {
+        return false;
+    }
+    if (q_frames.isEmpty()) {
+        return fail(JsonStream::SyntaxError);
+    }
+    qint64 &left = q_frames[q_frames.size() - 1];
+    if (left < 0) {
+        if (q_ptr == q_end) {
+            return fail(JsonStream::SyntaxError);
+        }
+        if (uchar(*q_ptr) == 0xFF) {
+            ++q_ptr;
+            q_frames.removeLast();
+            return false;
+        }
+        return true;
+    }
+    if (left == 0) {
+        q_frames.removeLast();
+        return false;
+    }
+    --left;
+    return true;
+}
+
+inline bool CborReader::skipItem(int depth) {
+    if (depth > MaxDepth) {
+        return fail(JsonStream::SyntaxError);
+    }
+    const char *start = q_ptr;
+    int major = 0;
+    quint64 arg = 0;
+    bool indefinite = false;
+    if (!readHead(&major, &arg, &indefinite)) {
+        return false;
+    }
+    switch (major) {
+        case 2:
+        case 3: {
+            const char *str;
+            qint64 len;
+            q_ptr = start;
+            return readChunks(&str, &len);
+        }
+        case 4:
+        case 5: {
+            if (indefinite) {
+                while (true) {
+                    if (q_ptr == q_end) {
+                        return fail(JsonStream::SyntaxError);
+                    }
+                    if (uchar(*q_ptr) == 0xFF) {
+                        ++q_ptr;
+                        return true;
+                    }
+                    if (!skipItem(depth + 1) || (major == 5 && !skipItem(depth + 1))) {
+                        return false;
+                    }
+                }
+            }
+            if (arg > quint64(q_end - q_ptr)) {
+                return fail(JsonStream::SyntaxError);
+            }
+            quint64 count = major == 5 ? arg * 2 : arg;
+            for (quint64 i = 0; i < count; ++i) {
+                if (!skipItem(depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case 6:
+            return skipItem(depth + 1);
+        default:
+            break;
+    }
+    return true;
+}
+
+#define QCBORREADER_OUTPUT(VAL, TYPE)                                                                                 \
+    qint64 _l = 0;                                                                                                     \
+    if (readInteger(&_l)) {                                                                                            \
+        if (_l < qint64(std::numeric_limits<TYPE>::min()) || _l > qint64(std::numeric_limits<TYPE>::max())) {         \
+            outOfRange();                                                                                              \
+        } else {                                                                                                       \
+            VAL = TYPE(_l);                                                                                            \
+        }                                                                                                              \
+    }
+
+inline CborReader &CborReader::operator>>(qint8 &sc) {
+    QCBORREADER_OUTPUT(sc, qint8);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(quint8 &c) {
+    QCBORREADER_OUTPUT(c, quint8);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(qint16 &s) {
+    QCBORREADER_OUTPUT(s, qint16);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(quint16 &us) {
+    QCBORREADER_OUTPUT(us, quint16);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(qint32 &i) {
+    QCBORREADER_OUTPUT(i, qint32);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(quint32 &u) {
+    QCBORREADER_OUTPUT(u, quint32);
+    return *this;
+}
+
+#undef QCBORREADER_OUTPUT
+
+inline CborReader &CborReader::operator>>(qint64 &l) {
+    readInteger(&l);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(quint64 &ul) {
+    readUnsigned(&ul);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(float &f) {
+    double d = 0;
+    if (readDouble(&d)) {
+        f = float(d);
+    }
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(double &d) {
+    readDouble(&d);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(bool &b) {
+    readBool(&b);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(QString &s) {
+    if (q_validateOnly) {
+        Utf8View str;
+        readString(&str);
+        return *this;
+    }
+    readString(&s);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(QJsonValue &val) {
+    if (q_validateOnly) {
+        const char *data = nullptr;
+        int size = 0;
+        readRaw(&data, &size);
+        return *this;
+    }
+    readValue(&val);
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(QJsonArray &arr) {
+    if (peek() != Array) {
+        fail(JsonStream::TypeNotMatch);
+        return *this;
+    }
+    if (q_validateOnly) {
+        skipValue();
+        return *this;
+    }
+    QJsonValue val;
+    if (readValue(&val)) {
+        arr = val.toArray();
+    }
+    return *this;
+}
+
+inline CborReader &CborReader::operator>>(QJsonObject &obj) {
+    if (peek() != Map) {
+        fail(JsonStream::TypeNotMatch);
+        return *this;
+    }
+    if (q_validateOnly) {
+        skipValue();
+        return *this;
+    }
+    QJsonValue val;
+    if (readValue(&val)) {
+        obj = val.toObject();
+    }
+    return *this;
+}
+
+// ----------------------------------
+// User Implementation Part
+// ----------------------------------
+
+/* Fallback for classes which only have JsonStream implementations */
+template <class T>
+CborReader &operator>>(CborReader &reader, T &var) {
+    QJsonValue val;
+    if (!reader.readValue(&val)) {
+        return reader;
+    }
+    JsonStream stream(val);
+    stream >> var;
+    reader.setStatus(stream.status());
+    return reader;
+}
+
+// ----------------------------------
+// Private Part
+// ----------------------------------
+
+namespace CborReaderUtils {
+
+    inline bool parseAsObject(CborReader &reader, const char *typeName) {
+        CborReader::Type type = reader.peek();
+        if (type != CborReader::Map && type != CborReader::Invalid) {
+            qAsDbg() << typeName << ": expect map, but get " << type;
+        }
+        return reader.beginObject();
+    }
+
+    inline bool parseAsArray(CborReader &reader, const char *typeName) {
+        CborReader::Type type = reader.peek();
+        if (type != CborReader::Array && type != CborReader::Invalid) {
+            qAsDbg() << typeName << ": expect array, but get " << type;
+        }
+        return reader.beginArray();
+    }
+
+    inline bool parseAsString(CborReader &reader, const char *typeName, QString *out) {
+        CborReader::Type type = reader.peek();
+        if (type != CborReader::TextString && type != CborReader::Invalid) {
+            qAsDbg() << typeName << ": expect string, but get " << type;
+        }
+        return reader.readString(out);
+    }
+
+    inline bool parseAsString(CborReader &reader, const char *typeName, Utf8View *out) {
+        CborReader::Type type = reader.peek();
+        if (type != CborReader::TextString && type != CborReader::Invalid) {
+            qAsDbg() << typeName << ": expect string, but get " << type;
+        }
+        return reader.readString(out);
+    }
+
+    template <class T>
+    bool parseObjectMember(CborReader &reader, const char *key, const char *typeName, T *out) {
+        if (reader.mask().isFull()) {
+            reader >> *out;
+        } else {
+            const FieldMask::Cursor mask = reader.mask();
+            reader.setMask(mask.child(Utf8View(key)));
+            reader >> *out;
+            reader.setMask(mask);
+        }
+
+        // If failed
+        if (!reader.good()) {
+            qAsDbg() << typeName << ": fail at key " << key;
+            return false;
+        }
+        return true;
+    }
+
+    // Constraints check the value, so it's decoded even if the reader only validates
+    template <class T>
+    bool parseConstrainedMember(CborReader &reader, const char *key, const char *typeName, T *out) {
+        const bool validateOnly = reader.validateOnly();
+        reader.setValidateOnly(false);
+        bool res = parseObjectMember(reader, key, typeName, out);
+        reader.setValidateOnly(validateOnly);
+        return res;
+    }
+
+    using ReaderUtils::DerivedClass;
+    using ReaderUtils::derivedClass;
+
+    // Polymorphic pointer, the same as JsonReaderUtils::parsePolymorphic()
+    template <class BASE, class TYPE, class... CLASSES>
+    CborReader &parsePolymorphic(CborReader &reader, QSharedPointer<BASE> &var, const char *key,
+                                 const char *typeName, TYPE BASE::*member, CLASSES... classes) {
+        CborReader scan = reader.slice(reader.position(), reader.size());
+        scan.setValidateOnly(false);
+        scan.setMask(FieldMask::Cursor());
+        if (!parseAsObject(scan, typeName)) {
+            reader.setStatus(scan.status());
+            return reader;
+        }
+
+        TYPE type{};
+        bool found = false;
+        Utf8View name;
+        while (!found && scan.nextMember(&name)) {
+            if (name == Utf8View(key)) {
+                found = parseObjectMember(scan, key, typeName, &type);
+            } else if (!scan.skipValue()) {
+                break;
+            }
+        }
+        if (!scan.good()) {
+            reader.setStatus(scan.status());
+            return reader;
+        }
+        if (!found) {
+            reader.setStatus(JsonStream::KeyNotFound);
+            return reader;
+        }
+        return ReaderUtils::parseDerived(reader, var, member, type, classes...);
+    }
+
+    // Layout of a RFC 8746 typed array
+    struct TypedArrayFormat {
+        int size;
+        bool isFloat;
+        bool isSigned;
+        bool little;
+    };
+
+    inline bool typedArrayFormat(quint64 tag, TypedArrayFormat *out) {
+        if (tag < 64 || tag > 87) {
+            return false;
+        }
+        int bits = int(tag - 64);
+        int ll = bits & 3;
+        out->isFloat = bits & 16;
+        out->isSigned = bits & 8;
+        out->little = bits & 4;
+        if (out->isFloat) {
+            // Only float and double
+            if (out->isSigned || ll == 0 || ll == 3) {
+                return false;
+            }
+            out->size = 2 << ll;
+        } else {
+            out->size = 1 << ll;
+            // Uint8 clamped is allowed, signed one is reserved
+            if (ll == 0 && out->little && out->isSigned) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Element of a float list, converted like CborReader::operator>>(double)
+    template <class T, class V>
+    bool typedArrayValue(V v, T *out, std::true_type) {
+        *out = T(v);
+        return true;
+    }
+
+    // Element of an integer list, it must fit into T
+    template <class T>
+    bool typedArrayValue(qint64 l, T *out, std::false_type) {
+        if (l < 0 ? !std::is_signed<T>::value || l < qint64(std::numeric_limits<T>::min())
+                  : quint64(l) > quint64(std::numeric_limits<T>::max())) {
+            return false;
+        }
+        *out = T(l);
+        return true;
+    }
+
+    template <class T>
+    bool typedArrayValue(quint64 ul, T *out, std::false_type) {
+        if (ul > quint64(std::numeric_limits<T>::max())) {
+            return false;
+        }
+        *out = T(ul);
+        return true;
+    }
+
+    // Floats are truncated like CborReader::readInteger(), NaN never fits
+    template <class T>
+    bool typedArrayValue(double d, T *out, std::false_type) {
+        if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0)) {
+            return false;
+        }
+        return typedArrayValue(qint64(d), out, std::false_type());
+    }
+
+    template <class T>
+    bool typedArrayElement(const TypedArrayFormat &fmt, const char *p, T *out) {
+        char buf[8];
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        bool swap = !fmt.little && fmt.size > 1;
+#else
+        bool swap = fmt.little && fmt.size > 1;
+#endif
+        for (int i = 0; i < fmt.size; ++i) {
+            buf[i] = swap ? p[fmt.size - 1 - i] : p[i];
+        }
+
+#define QCBORREADER_ELEMENT(TYPE, VALUE)                                                                              \
+    {                                                                                                                  \
+        TYPE _v;                                                                                                       \
+        memcpy(&_v, buf, sizeof(TYPE));                                                                                \
+        return typedArrayValue(VALUE(_v), out, std::is_floating_point<T>());                                           \
+    }
+        if (fmt.isFloat) {
+            if (fmt.size == 4)
+                QCBORREADER_ELEMENT(float, double)
+            QCBORREADER_ELEMENT(double, double)
+        }
+        switch (fmt.size) {
+            case 1:
+                if (fmt.isSigned)
+                    QCBORREADER_ELEMENT(qint8, qint64)
+                QCBORREADER_ELEMENT(quint8, quint64)
+            case 2:
+                if (fmt.isSigned)
+                    QCBORREADER_ELEMENT(qint16, qint64)
+                QCBORREADER_ELEMENT(quint16, quint64)
+            case 4:
+                if (fmt.isSigned)
+                    QCBORREADER_ELEMENT(qint32, qint64)
+                QCBORREADER_ELEMENT(quint32, quint64)
+            default:
+                if (fmt.isSigned)
+                    QCBORREADER_ELEMENT(qint64, qint64)
+                QCBORREADER_ELEMENT(quint64, quint64)
+        }
+#undef QCBORREADER_ELEMENT
+    }
+
+}
+
+// ----------------------------------
+// Supported Containers
+// ----------------------------------
+
+namespace CborReaderContainers {
+
+    template <class T>
+    struct IsTypedElement {
+        static const bool value = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+    };
+
+    template <class LIST>
+    CborReader &writeTypedList(CborReader &reader, LIST &list, std::false_type) {
+        qAsDbg() << QAS_TYPE_NAME(list) << ": unexpected typed array";
+        reader.setStatus(JsonStream::TypeNotMatch);
+        return reader;
+    }
+
+    template <class LIST>
+    CborReader &writeTypedList(CborReader &reader, LIST &list, std::true_type) {
+        quint64 tag = 0;
+        CborReaderUtils::TypedArrayFormat fmt;
+        QByteArray data;
+        if (!reader.readTag(&tag)) {
+            return reader;
+        }
+        if (!CborReaderUtils::typedArrayFormat(tag, &fmt)) {
+            qAsDbg() << QAS_TYPE_NAME(list) << ": unsupported tag " << tag;
+            reader.setStatus(JsonStream::TypeNotMatch);
+            return reader;
+        }
+        if (!reader.readBytes(&data)) {
+            return reader;
+        }
+        if (data.size() % fmt.size != 0) {
+            reader.setStatus(JsonStream::SyntaxError);
+            return reader;
+        }
+
+        // Every element must fit into the value type, in place mode appends to the cleared list directly
+        typedef typename LIST::value_type T;
+        LIST tmpList;
+        LIST &dst = reader.inPlace() ? list : tmpList;
+        if (!reader.validateOnly()) {
+            dst.clear();
+            ReaderContainers::reserve(dst, data.size() / fmt.size);
+        }
+        int index = 0;
+        for (const char *p = data.constData(); p != data.constData() + data.size(); p += fmt.size) {
+            T val{};
+            if (!CborReaderUtils::typedArrayElement<T>(fmt, p, &val)) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": element out of range at index " << index;
+                reader.setStatus(JsonStream::TypeNotMatch);
+                return reader;
+            }
+            if (!reader.validateOnly()) {
+                ReaderContainers::append(dst, val);
+            }
+            ++index;
+        }
+        if (reader.validateOnly()) {
+            return reader;
+        }
+        if (&dst != &list) {
+            list = std::move(tmpList);
+        }
+        return reader;
+    }
+
+    // List Implementations
+    template <class LIST>
+    CborReader &writeList(CborReader &reader, LIST &list) {
+        if (reader.peek() == CborReader::Tag) {
+            return writeTypedList(reader, list,
+                                  std::integral_constant<bool, IsTypedElement<typename LIST::value_type>::value>());
+        }
+
+        // Check type
+        if (!CborReaderUtils::parseAsArray(reader, QAS_TYPE_NAME(list))) {
+            return reader;
+        }
+        if (reader.validateOnly()) {
+            return ReaderContainers::checkList(reader, list);
+        }
+        if (reader.inPlace()) {
+            return ReaderContainers::updateList(
+                    reader, list, std::integral_constant<bool, ReaderContainers::IsUpdatable<LIST>::value>());
+        }
+
+        // Write
+        LIST tmpList;
+        int index = 0;
+        while (reader.nextElement()) {
+            if (JsonStreamPrivate::IsParallel<typename LIST::value_type>::value && reader.threadPool() &&
+                index == reader.parallelThreshold()) {
+                return ReaderContainers::writeParallel(reader, list, tmpList, index);
+            }
+            typename LIST::value_type tmp{};
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
+                return reader;
+            }
+
+            ReaderContainers::append(tmpList, std::move(tmp));
+            ++index;
+        }
+        if (reader.good()) {
+            list = std::move(tmpList);
+        }
+        return reader;
+    }
+
+    // Map Implementations
+    template <class MAP, class OP>
+    CborReader &writeMap(CborReader &reader, MAP &map, OP op) {
+        // Check type
+        if (!CborReaderUtils::parseAsObject(reader, QAS_TYPE_NAME(map))) {
+            return reader;
+        }
+        if (reader.validateOnly()) {
+            return ReaderContainers::checkMap(reader, map);
+        }
+        if (reader.inPlace()) {
+            return ReaderContainers::updateMap(reader, map, op);
+        }
+        MAP tmpMap;
+
+        Utf8View key;
+        while (reader.nextMember(&key)) {
+            // Keys are only valid until next member
+            QString name = QString::fromUtf8(key.data(), key.size());
+            typename MAP::mapped_type tmp{};
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(map) << ": fail at key " << name;
+                return reader;
+            }
+
+            // Use operator to insert
+            op.insert(tmpMap, std::move(name), std::move(tmp));
+        }
+        if (reader.good()) {
+            map = std::move(tmpMap);
+        }
+        return reader;
+    }
+
+}
+
+// std::vector
+template <class T>
+CborReader &operator>>(CborReader &reader, std::vector<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+// std::list
+template <class T>
+CborReader &operator>>(CborReader &reader, std::list<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+// std::set
+template <class T>
+CborReader &operator>>(CborReader &reader, std::set<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+// QList
+template <class T>
+CborReader &operator>>(CborReader &reader, QList<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+#endif
+
+// QSet
+template <class T>
+CborReader &operator>>(CborReader &reader, QSet<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+// QVector
+template <class T>
+CborReader &operator>>(CborReader &reader, QVector<T> &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+// QStringList
+inline CborReader &operator>>(CborReader &reader, QStringList &list) {
+    return QAS::CborReaderContainers::writeList(reader, list);
+}
+
+// std::map
+template <class T>
+CborReader &operator>>(CborReader &reader, std::map<QString, T> &map) {
+    return QAS::CborReaderContainers::writeMap(reader, map, STLMapOps());
+}
+
+// std::unordered_map
+template <class T>
+CborReader &operator>>(CborReader &reader, std::unordered_map<QString, T> &map) {
+    return QAS::CborReaderContainers::writeMap(reader, map, STLMapOps());
+}
+
+// QMap
+template <class T>
+CborReader &operator>>(CborReader &reader, QMap<QString, T> &map) {
+    return QAS::CborReaderContainers::writeMap(reader, map, QtMapOps());
+}
+
+// QHash
+template <class T>
+CborReader &operator>>(CborReader &reader, QHash<QString, T> &map) {
+    return QAS::CborReaderContainers::writeMap(reader, map, QtMapOps());
+}
+
+QAS_END_NAMESPACE
+
+// ----------------------------------
+// Simplified Macros or Functions
+// ----------------------------------
+
+// CBOR Data -> Non-Basic Class
+template <class T>
+bool qAsCborTryGetClass(const QByteArray &data, T *out) {
+    QAS::CborReader reader(data);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::CborReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsCborGetClass(const QByteArray &data) {
+    T tmp{};
+    qAsCborTryGetClass(data, &tmp);
+    return tmp;
+}
+
+// CBOR Data -> Existing Non-Basic Class, reusing its storage and partially updated on failure
+template <class T>
+bool qAsCborTryUpdateClass(const QByteArray &data, T *out) {
+    QAS::CborReader reader(data);
+    reader.setInPlace(true);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::CborReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+// CBOR Data -> Non-Basic Class, reading only the members selected by the mask
+template <class T>
+bool qAsCborTryGetClassPartial(const QByteArray &data, const QAS::FieldMask &mask, T *out) {
+    QAS::CborReader reader(data);
+    reader.setMask(&mask);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::CborReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsCborGetClassPartial(const QByteArray &data, const QAS::FieldMask &mask) {
+    T tmp{};
+    qAsCborTryGetClassPartial(data, mask, &tmp);
+    return tmp;
+}
+
+// CBOR Data -> Check against Non-Basic Class, nothing is kept and member storage isn't allocated
+template <class T>
+bool qAsCborValidate(const QByteArray &data, QAS::JsonStream::Status *status = nullptr) {
+    QAS::CborReader reader(data);
+    reader.setValidateOnly(true);
+    T tmp{};
+    reader >> tmp;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::CborReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    if (status) {
+        *status = reader.status();
+    }
+    return reader.good();
+}
+
+// CBOR File -> Non-Basic Class, the file is mapped and parsed from the mapping instead of being read into memory
+template <class T>
+bool qAsCborTryLoadFile(const QString &path, T *out) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qAsDbg() << "QAS::CborReader: failed to open " << path;
+        return false;
+    }
+    QByteArray buf;
+    const char *data = nullptr;
+    qint64 size = 0;
+    QAS::ReaderUtils::mapFile(file, &buf, &data, &size);
+
+    // Typed arrays are decoded out of the viewed byte strings, no value refers to the mapping
+    QAS::CborReader reader(data, size);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::CborReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsCborLoadFile(const QString &path) {
+    T tmp{};
+    qAsCborTryLoadFile(path, &tmp);
+    return tmp;
+}
+
+#endif // QCBORREADER_H
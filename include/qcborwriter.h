@@ -0,0 +1,593 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QCBORWRITER_H
+#define QCBORWRITER_H
+
+#include "qjsonstream.h"
+
+#include <QCborStreamWriter>
+#include <QIODevice>
+#include <QVarLengthArray>
+
+#include <cmath>
+#include <cstring>
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * CborWriter emits CBOR (RFC 8949) through QCborStreamWriter, the generated serializers use it
+ * with the same keys and layout as JsonWriter.
+ *
+ * Maps are called objects to keep the interface of JsonWriter. Lists of numbers are written as
+ * little endian typed arrays (RFC 8746).
+ *
+ */
+
+class CborWriter {
+public:
+    enum {
+        BufferSize = 16 * 1024,
+    };
+
+    explicit CborWriter(QByteArray *out);
+    explicit CborWriter(QIODevice *device);
+    ~CborWriter();
+
+    inline QCborStreamWriter &stream() {
+        return q_writer;
+    }
+
+    /* Write the remaining buffer to device, returns false if the device fails */
+    bool flush();
+    bool hasError() const;
+
+    void beginObject(qint64 size = -1);
+    void endObject();
+    void beginArray(qint64 size = -1);
+    void endArray();
+
+    /* Let the next object write its members into the current object */
+    void mergeObject();
+
+    void writeKey(Utf8View key);
+    void writeKey(QLatin1String key);
+    void writeKey(const QString &key);
+
+    void writeString(Utf8View s);
+    void writeString(QLatin1String s);
+    void writeString(const QString &s);
+    void writeDouble(double d);
+    void writeFloat(float f);
+    void writeInteger(qint64 l);
+    void writeUnsigned(quint64 ul);
+    void writeBool(bool b);
+    void writeNull();
+    void writeValue(const QJsonValue &val);
+    void writeTypedArray(quint64 tag, const char *data, qint64 size);
+
+public:
+    CborWriter &operator<<(qint8 sc);
+    CborWriter &operator<<(quint8 c);
+    CborWriter &operator<<(qint16 s);
+    CborWriter &operator<<(quint16 us);
+    CborWriter &operator<<(qint32 i);
+    CborWriter &operator<<(quint32 u);
+    CborWriter &operator<<(qint64 l);
+    CborWriter &operator<<(quint64 ul);
+    CborWriter &operator<<(bool b);
+    CborWriter &operator<<(float f);
+    CborWriter &operator<<(double d);
+    CborWriter &operator<<(const QString &s);
+    CborWriter &operator<<(const QJsonValue &val);
+    CborWriter &operator<<(const QJsonArray &arr);
+    CborWriter &operator<<(const QJsonObject &obj);
+
+private:
+    // Buffers the output of QCborStreamWriter and records device errors
+    class Device : public QIODevice {
+    public:
+        explicit Device(QIODevice *target) : target(target), error(false) {
+            buf.reserve(BufferSize);
+            open(QIODevice::WriteOnly);
+        }
+
+        bool flush() {
+            if (!buf.isEmpty()) {
+                if (target->write(buf) != buf.size()) {
+                    error = true;
+                }
+                buf.resize(0);
+            }
+            return !error;
+        }
+
+        QIODevice *target;
+        QByteArray buf;
+        bool error;
+
+    protected:
+        qint64 readData(char *data, qint64 maxlen) override {
+            Q_UNUSED(data);
+            Q_UNUSED(maxlen);
+            return -1;
+        }
+
+        qint64 writeData(const char *data, qint64 len) override {
+            // Large byte strings go to the target directly, they may not fit into the buffer
+            if (len >= BufferSize) {
+                flush();
+                if (!error && target->write(data, len) != len) {
+                    error = true;
+                }
+                return len;
+            }
+            buf.append(data, int(len));
+            if (buf.size() >= BufferSize) {
+                flush();
+            }
+            return len;
+        }
+    };
+
+    enum FrameType : char {
+        ObjectFrame,
+        MergedFrame,
+        ArrayFrame,
+    };
+
+    Device *q_device;
+    QCborStreamWriter q_writer;
+
+    QVarLengthArray<char, 32> q_frames;
+    bool q_merge;
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+inline CborWriter::CborWriter(QByteArray *out) : q_device(nullptr), q_writer(out), q_merge(false) {
+}
+
+inline CborWriter::CborWriter(QIODevice *device)
+    : q_device(new Device(device)), q_writer(q_device), q_merge(false) {
+}
+
+inline CborWriter::~CborWriter() {
+    if (q_device) {
+        q_device->flush();
+        q_writer.setDevice(nullptr);
+        delete q_device;
+    }
+}
+
+inline bool CborWriter::flush() {
+    return q_device ? q_device->flush() : true;
+}
+
+inline bool CborWriter::hasError() const {
+    return q_device && q_device->error;
+}
+
+inline void CborWriter::beginObject(qint64 size) {
+    if (q_merge) {
+        q_merge = false;
+        q_frames.append(MergedFrame);
+        return;
+    }
+    if (size < 0) {
+        q_writer.startMap();
+    } else {
+        q_writer.startMap(quint64(size));
+    }
+    q_frames.append(ObjectFrame);
+}
+
+inline void CborWriter::endObject() {
+    if (q_frames.isEmpty()) {
+        return;
+    }
+    char frame = q_frames.last();
+    q_frames.removeLast();
+    if (frame == ObjectFrame) {
+        q_writer.endMap();
+    } else if (frame == ArrayFrame) {
+        q_writer.endArray();
+    }
+}
+
+inline void CborWriter::beginArray(qint64 size) {
+    q_merge = false;
+    if (size < 0) {
+        q_writer.startArray();
+    } else {
+        q_writer.startArray(quint64(size));
+    }
+    q_frames.append(ArrayFrame);
+}
+
+inline void CborWriter::endArray() {
+    endObject();
+}
+
+inline void CborWriter::mergeObject() {
+    q_merge = !q_frames.isEmpty();
+}
+
+inline void CborWriter::writeKey(Utf8View key) {
+    q_writer.appendTextString(key.data(), key.size());
+}
+
+inline void CborWriter::writeKey(QLatin1String key) {
+    q_writer.append(key);
+}
+
+inline void CborWriter::writeKey(const QString &key) {
+    q_writer.append(key);
+}
+
+inline void CborWriter::writeString(Utf8View s) {
+    q_merge = false;
+    q_writer.appendTextString(s.data(), s.size());
+}
+
+inline void CborWriter::writeString(QLatin1String s) {
+    q_merge = false;
+    q_writer.append(s);
+}
+
+inline void CborWriter::writeString(const QString &s) {
+    q_merge = false;
+    q_writer.append(s);
+}
+
+inline void CborWriter::writeDouble(double d) {
+    // Integral values are written as integers, others in the shortest exact float, -0 stays a float
+    if (std::abs(d) < 9007199254740992.0 && d == double(qint64(d)) && !(d == 0 && std::signbit(d))) {
+        writeInteger(qint64(d));
+        return;
+    }
+    q_merge = false;
+    if (double(float(d)) == d) {
+        q_writer.append(float(d));
+    } else {
+        q_writer.append(d);
+    }
+}
+
+inline void CborWriter::writeFloat(float f) {
+    q_merge = false;
+    q_writer.append(f);
+}
+
+inline void CborWriter::writeInteger(qint64 l) {
+    q_merge = false;
+    q_writer.append(l);
+}
+
+inline void CborWriter::writeUnsigned(quint64 ul) {
+    q_merge = false;
+    q_writer.append(ul);
+}
+
+inline void CborWriter::writeBool(bool b) {
+    q_merge = false;
+    q_writer.append(b);
+}
+
+inline void CborWriter::writeNull() {
+    q_merge = false;
+    q_writer.appendNull();
+}
+
+inline void CborWriter::writeValue(const QJsonValue &val) {
+    switch (val.type()) {
+        case QJsonValue::Object: {
+            const QJsonObject &obj = val.toObject();
+            beginObject(obj.size());
+            for (auto it = obj.begin(); it != obj.end(); ++it) {
+                writeKey(it.key());
+                writeValue(it.value());
+            }
+            endObject();
+            break;
+        }
+        case QJsonValue::Array: {
+            const QJsonArray &arr = val.toArray();
+            beginArray(arr.size());
+            for (const auto &item : arr) {
+                writeValue(item);
+            }
+            endArray();
+            break;
+        }
+        case QJsonValue::String:
+            writeString(val.toString());
+            break;
+        case QJsonValue::Double:
+            writeDouble(val.toDouble());
+            break;
+        case QJsonValue::Bool:
+            writeBool(val.toBool());
+            break;
+        default:
+            writeNull();
+            break;
+    }
+}
+
+inline void CborWriter::writeTypedArray(quint64 tag, const char *data, qint64 size) {
+    q_merge = false;
+    q_writer.append(QCborTag(tag));
+    q_writer.appendByteString(data, size);
+}
+
+inline CborWriter &CborWriter::operator<<(qint8 sc) {
+    writeInteger(sc);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(quint8 c) {
+    writeInteger(c);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(qint16 s) {
+    writeInteger(s);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(quint16 us) {
+    writeInteger(us);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(qint32 i) {
+    writeInteger(i);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(quint32 u) {
+    writeInteger(u);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(qint64 l) {
+    writeInteger(l);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(quint64 ul) {
+    writeUnsigned(ul);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(bool b) {
+    writeBool(b);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(float f) {
+    writeFloat(f);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(double d) {
+    writeDouble(d);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(const QString &s) {
+    writeString(s);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(const QJsonValue &val) {
+    writeValue(val);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(const QJsonArray &arr) {
+    writeValue(arr);
+    return *this;
+}
+
+inline CborWriter &CborWriter::operator<<(const QJsonObject &obj) {
+    writeValue(obj);
+    return *this;
+}
+
+// Fallback for classes which only have JsonStream operators
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const T &var) {
+    writer.writeValue(JsonStream::fromValue(var).data());
+    return writer;
+}
+
+// ----------------------------------
+// Supported Containers
+// ----------------------------------
+
+namespace CborWriterContainers {
+
+    // RFC 8746 tag of little endian typed arrays, 8-bit types have no byte order
+    template <class T>
+    struct TypedArrayTag {
+        static const bool supported = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                      (std::is_integral<T>::value || sizeof(T) == 4 || sizeof(T) == 8);
+        static const quint64 value = 64 + (std::is_floating_point<T>::value ? 16 : 0) +
+                                     (std::is_integral<T>::value && std::is_signed<T>::value ? 8 : 0) +
+                                     (sizeof(T) > 1 ? 4 : 0) +
+                                     (sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3) -
+                                     (std::is_floating_point<T>::value ? 1 : 0);
+    };
+
+    template <class T>
+    void storeLittleEndian(const T &val, char *dst) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        memcpy(dst, &val, sizeof(T));
+#else
+        const char *src = reinterpret_cast<const char *>(&val);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            dst[i] = src[sizeof(T) - 1 - i];
+        }
+#endif
+    }
+
+    // List Implementations
+    template <class LIST>
+    CborWriter &readList(CborWriter &writer, const LIST &list, std::false_type) {
+        writer.beginArray(qint64(list.size()));
+        for (const auto &item : list) {
+            writer << item;
+        }
+        writer.endArray();
+        return writer;
+    }
+
+    template <class LIST>
+    CborWriter &readList(CborWriter &writer, const LIST &list, std::true_type) {
+        typedef typename LIST::value_type T;
+        // The byte string must fit into a QByteArray, a larger list is written as an array
+        if (quint64(list.size()) > quint64(JsonStreamPrivate::MaxSize) / sizeof(T)) {
+            return readList(writer, list, std::false_type());
+        }
+        QByteArray data;
+        data.resize(int(list.size() * sizeof(T)));
+        char *p = data.data();
+        for (const auto &item : list) {
+            storeLittleEndian(item, p);
+            p += sizeof(T);
+        }
+        writer.writeTypedArray(TypedArrayTag<T>::value, data.constData(), data.size());
+        return writer;
+    }
+
+    template <class LIST>
+    CborWriter &readList(CborWriter &writer, const LIST &list) {
+        return readList(writer, list,
+                        std::integral_constant<bool, TypedArrayTag<typename LIST::value_type>::supported>());
+    }
+
+    // Map Implementations
+    template <class MAP, class OP>
+    CborWriter &readMap(CborWriter &writer, const MAP &map, OP op) {
+        writer.beginObject(qint64(map.size()));
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            writer.writeKey(op.key(it));
+            writer << op.value(it);
+        }
+        writer.endObject();
+        return writer;
+    }
+
+}
+
+// std::vector
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const std::vector<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+// std::list
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const std::list<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+// std::set
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const std::set<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+// QList
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const QList<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+#endif
+
+// QSet
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const QSet<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+// QVector
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const QVector<T> &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+// QStringList
+inline CborWriter &operator<<(CborWriter &writer, const QStringList &list) {
+    return QAS::CborWriterContainers::readList(writer, list);
+}
+
+// std::map
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const std::map<QString, T> &map) {
+    return QAS::CborWriterContainers::readMap(writer, map, STLMapOps());
+}
+
+// std::unordered_map
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const std::unordered_map<QString, T> &map) {
+    return QAS::CborWriterContainers::readMap(writer, map, STLMapOps());
+}
+
+// QMap
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const QMap<QString, T> &map) {
+    return QAS::CborWriterContainers::readMap(writer, map, QtMapOps());
+}
+
+// QHash
+template <class T>
+CborWriter &operator<<(CborWriter &writer, const QHash<QString, T> &map) {
+    return QAS::CborWriterContainers::readMap(writer, map, QtMapOps());
+}
+
+QAS_END_NAMESPACE
+
+// ----------------------------------
+// Simplified Macros or Functions
+// ----------------------------------
+
+// Non-Basic Class -> CBOR
+template <class T>
+QByteArray qAsClassToCbor(const T &var) {
+    QByteArray data;
+    {
+        QAS::CborWriter writer(&data);
+        writer << var;
+    }
+    return data;
+}
+
+template <class T>
+bool qAsClassWriteCbor(const T &var, QIODevice *device) {
+    QAS::CborWriter writer(device);
+    writer << var;
+    return writer.flush();
+}
+
+#endif // QCBORWRITER_H
@@ -0,0 +1,1412 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QJSONREADER_H
+#define QJSONREADER_H
+
+#include "qasreaderutils.h"
+#include "qjsonstream.h"
+
+#include <QFile>
+#include <QSharedPointer>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * JsonReader is a pull parser over UTF-8 json text, the generated deserializers use it to
+ * write into class members directly without building a QJsonDocument first.
+ *
+ * The reader doesn't copy the input, the data must stay alive while reading.
+ *
+ */
+
+class JsonReader {
+public:
+    enum {
+        MaxDepth = 1024,
+        ParallelThreshold = 32,
+    };
+
+    explicit JsonReader(const QByteArray &data);
+    JsonReader(const char *data, qint64 size);
+    ~JsonReader() = default;
+
+    JsonStream::Status status() const;
+    void setStatus(JsonStream::Status status);
+    void resetStatus();
+
+    inline bool failed() const {
+        return q_status & JsonStream::Failed;
+    }
+
+    inline bool good() const {
+        return q_status & JsonStream::Success;
+    }
+
+    /* Read into existing values reusing their storage, a failed read leaves them partially updated */
+    inline bool inPlace() const {
+        return q_inPlace;
+    }
+
+    inline void setInPlace(bool inPlace) {
+        q_inPlace = inPlace;
+    }
+
+    /* Only check the input, values are read into temporaries and dropped, strings aren't decoded */
+    inline bool validateOnly() const {
+        return q_validateOnly;
+    }
+
+    inline void setValidateOnly(bool validateOnly) {
+        q_validateOnly = validateOnly;
+    }
+
+    /* Decode the elements of lists on the pool after the first threshold ones, nullptr reads on the calling thread */
+    inline QThreadPool *threadPool() const {
+        return q_pool;
+    }
+
+    inline int parallelThreshold() const {
+        return q_parallelThreshold;
+    }
+
+    inline void setThreadPool(QThreadPool *pool, int threshold = ParallelThreshold) {
+        q_pool = pool;
+        q_parallelThreshold = qMax(0, threshold);
+    }
+
+    /* Members to read, set by the generated readers while they descend, see FieldMask */
+    inline const FieldMask::Cursor &mask() const {
+        return q_mask;
+    }
+
+    inline void setMask(const FieldMask::Cursor &mask) {
+        q_mask = mask;
+    }
+
+    /* Offset of the next token, seek() back only between complete values */
+    qint64 position() const;
+    void seek(qint64 pos);
+
+    /* Size of the input */
+    qint64 size() const;
+
+    /* Reader of the complete value in [begin, end) of the input with the same options */
+    JsonReader slice(qint64 begin, qint64 end) const;
+
+    /* Only whitespaces remain */
+    bool atEnd();
+
+    /* Type of the next value, returns Undefined if it's not a valid value */
+    QJsonValue::Type peek();
+
+    bool beginObject();
+    bool nextMember(Utf8View *key);
+    bool beginArray();
+    bool nextElement();
+
+    bool readString(QString *out);
+    bool readString(Utf8View *out);  // UTF-8 view, valid until the next read
+    bool readDouble(double *out);
+    bool readInteger(qint64 *out);   // Exact for integral text, truncated from double otherwise
+    bool readUnsigned(quint64 *out); // Same as readInteger()
+    bool readBool(bool *out);
+    bool readNull();
+    bool readValue(QJsonValue *out);
+    bool readRaw(QByteArray *out); // Text of the next value, copied
+    bool readRaw(Utf8View *out);   // Text of the next value, a view into the input
+    bool skipValue();
+
+public:
+    JsonReader &operator>>(qint8 &sc);
+    JsonReader &operator>>(quint8 &c);
+    JsonReader &operator>>(qint16 &s);
+    JsonReader &operator>>(quint16 &us);
+    JsonReader &operator>>(qint32 &i);
+    JsonReader &operator>>(quint32 &u);
+    JsonReader &operator>>(qint64 &l);
+    JsonReader &operator>>(quint64 &ul);
+    JsonReader &operator>>(bool &b);
+    JsonReader &operator>>(float &f);
+    JsonReader &operator>>(double &d);
+    JsonReader &operator>>(QString &s);
+    JsonReader &operator>>(QJsonValue &val);
+    JsonReader &operator>>(QJsonArray &arr);
+    JsonReader &operator>>(QJsonObject &obj);
+
+private:
+    QByteArray q_data;
+    const char *q_begin;
+    const char *q_end;
+    const char *q_ptr;
+
+    QByteArray q_buf; // Unescaped key
+    int q_depth;
+    bool q_first;
+    bool q_inPlace;
+    bool q_validateOnly;
+    QThreadPool *q_pool;
+    int q_parallelThreshold;
+    FieldMask::Cursor q_mask;
+    JsonStream::Status q_status;
+
+    void skipSpace();
+    bool fail(JsonStream::Status status);
+    bool scanString(const char **str, qint64 *len, bool *escaped);
+    bool unescape(const char *str, qint64 len, QByteArray *out);
+    bool scanNumber(const char **str, qint64 *len, bool *integral);
+    bool scanLiteral(const char *lit, int len);
+    bool checkSize(qint64 len);
+    bool readMagnitude(quint64 *abs, bool *negative);
+    bool outOfRange();
+    bool endContainer();
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+inline JsonReader::JsonReader(const QByteArray &data) : JsonReader(data.constData(), data.size()) {
+    q_data = data;
+}
+
+inline JsonReader::JsonReader(const char *data, qint64 size)
+    : q_begin(data), q_end(data + size), q_ptr(data), q_depth(0), q_first(false), q_inPlace(false),
+      q_validateOnly(false), q_pool(nullptr), q_parallelThreshold(ParallelThreshold), q_status(JsonStream::Ok) {
+    // Skip BOM
+    if (size >= 3 && !memcmp(data, "\xEF\xBB\xBF", 3)) {
+        q_ptr += 3;
+    }
+}
+
+inline JsonStream::Status JsonReader::status() const {
+    return q_status;
+}
+
+inline void JsonReader::setStatus(JsonStream::Status status) {
+    if (q_status == JsonStream::Ok)
+        q_status = status;
+}
+
+inline void JsonReader::resetStatus() {
+    q_status = JsonStream::Ok;
+}
+
+inline qint64 JsonReader::position() const {
+    return q_ptr - q_begin;
+}
+
+inline qint64 JsonReader::size() const {
+    return q_end - q_begin;
+}
+
+inline void JsonReader::seek(qint64 pos) {
+    q_ptr = q_begin + qBound(qint64(0), pos, qint64(q_end - q_begin));
+    q_first = false;
+}
+
+inline JsonReader JsonReader::slice(qint64 begin, qint64 end) const {
+    JsonReader reader(q_begin + begin, end - begin);
+    reader.q_depth = q_depth;
+    reader.q_inPlace = q_inPlace;
+    reader.q_validateOnly = q_validateOnly;
+    reader.q_pool = q_pool;
+    reader.q_parallelThreshold = q_parallelThreshold;
+    reader.q_mask = q_mask;
+    return reader;
+}
+
+inline bool JsonReader::atEnd() {
+    skipSpace();
+    return q_ptr == q_end;
+}
+
+inline QJsonValue::Type JsonReader::peek() {
+    skipSpace();
+    if (q_ptr == q_end) {
+        return QJsonValue::Undefined;
+    }
+    switch (*q_ptr) {
+        case '{':
+            return QJsonValue::Object;
+        case '[':
+            return QJsonValue::Array;
+        case '"':
+            return QJsonValue::String;
+        case 't':
+        case 'f':
+            return QJsonValue::Bool;
+        case 'n':
+            return QJsonValue::Null;
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return QJsonValue::Double;
+        default:
+            break;
+    }
+    return QJsonValue::Undefined;
+}
+
+inline bool JsonReader::beginObject() {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Object) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    if (++q_depth > MaxDepth) {
+        return fail(JsonStream::SyntaxError);
+    }
+    ++q_ptr;
+    q_first = true;
+    return true;
+}
+
+inline bool JsonReader::nextMember(Utf8View *key) {
+    if (!good()) {
+        return false;
+    }
+    skipSpace();
+    if (q_ptr != q_end && *q_ptr == '}') {
+        return endContainer();
+    }
+    if (!q_first) {
+        if (q_ptr == q_end || *q_ptr != ',') {
+            return fail(JsonStream::SyntaxError);
+        }
+        ++q_ptr;
+        skipSpace();
+    }
+    q_first = false;
+
+    // Key
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool escaped = false;
+    if (q_ptr == q_end || *q_ptr != '"' || !scanString(&str, &len, &escaped)) {
+        return fail(JsonStream::SyntaxError);
+    }
+    if (!checkSize(len)) {
+        return false;
+    }
+    if (escaped) {
+        if (!unescape(str, len, &q_buf)) {
+            return false;
+        }
+        *key = Utf8View(q_buf.constData(), q_buf.size());
+    } else {
+        *key = Utf8View(str, int(len));
+    }
+
+    skipSpace();
+    if (q_ptr == q_end || *q_ptr != ':') {
+        return fail(JsonStream::SyntaxError);
+    }
+    ++q_ptr;
+    return true;
+}
+
+inline bool JsonReader::beginArray() {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Array) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    if (++q_depth > MaxDepth) {
+        return fail(JsonStream::SyntaxError);
+    }
+    ++q_ptr;
+    q_first = true;
+    return true;
+}
+
+inline bool JsonReader::nextElement() {
+    if (!good()) {
+        return false;
+    }
+    skipSpace();
+    if (q_ptr != q_end && *q_ptr == ']') {
+        return endContainer();
+    }
+    if (!q_first) {
+        if (q_ptr == q_end || *q_ptr != ',') {
+            return fail(JsonStream::SyntaxError);
+        }
+        ++q_ptr;
+    }
+    q_first = false;
+    return true;
+}
+
+inline bool JsonReader::readString(QString *out) {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::String) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool escaped = false;
+    if (!scanString(&str, &len, &escaped) || !checkSize(len)) {
+        return false;
+    }
+
+    // Fast path
+    if (!escaped) {
+        JsonStreamPrivate::assignUtf8(out, str, len, q_inPlace);
+        return true;
+    }
+
+    QByteArray buf;
+    if (!unescape(str, len, &buf)) {
+        return false;
+    }
+    JsonStreamPrivate::assignUtf8(out, buf.constData(), buf.size(), q_inPlace);
+    return true;
+}
+
+inline bool JsonReader::readString(Utf8View *out) {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::String) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool escaped = false;
+    if (!scanString(&str, &len, &escaped) || !checkSize(len)) {
+        return false;
+    }
+
+    // Fast path
+    if (!escaped) {
+        *out = Utf8View(str, int(len));
+        return true;
+    }
+
+    if (!unescape(str, len, &q_buf)) {
+        return false;
+    }
+    *out = Utf8View(q_buf.constData(), q_buf.size());
+    return true;
+}
+
+inline bool JsonReader::readDouble(double *out) {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Double) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool integral = false;
+    if (!scanNumber(&str, &len, &integral) || !checkSize(len)) {
+        return false;
+    }
+
+    // Small integers are exact, parse them without conversion, "-0" keeps its sign
+    if (integral && len <= 16) {
+        const char *p = str;
+        bool negative = *p == '-';
+        if (negative) {
+            ++p;
+        }
+        qint64 val = 0;
+        for (; p < str + len; ++p) {
+            val = val * 10 + (*p - '0');
+        }
+        *out = negative ? -double(val) : double(val);
+        return true;
+    }
+
+    if (!JsonStreamPrivate::parseDouble(str, len, out)) {
+        return fail(JsonStream::SyntaxError);
+    }
+    return true;
+}
+
+inline bool JsonReader::readInteger(qint64 *out) {
+    quint64 abs = 0;
+    bool negative = false;
+    if (!readMagnitude(&abs, &negative)) {
+        return false;
+    }
+    if (abs > quint64(std::numeric_limits<qint64>::max()) + (negative ? 1 : 0)) {
+        return outOfRange();
+    }
+    *out = negative && abs ? -qint64(abs - 1) - 1 : qint64(abs);
+    return true;
+}
+
+inline bool JsonReader::readUnsigned(quint64 *out) {
+    quint64 abs = 0;
+    bool negative = false;
+    if (!readMagnitude(&abs, &negative)) {
+        return false;
+    }
+    if (negative && abs) {
+        return outOfRange();
+    }
+    *out = abs;
+    return true;
+}
+
+inline bool JsonReader::readBool(bool *out) {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Bool) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    if (*q_ptr == 't') {
+        *out = true;
+        return scanLiteral("true", 4);
+    }
+    *out = false;
+    return scanLiteral("false", 5);
+}
+
+inline bool JsonReader::readNull() {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Null) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+    return scanLiteral("null", 4);
+}
+
+inline bool JsonReader::readValue(QJsonValue *out) {
+    switch (peek()) {
+        case QJsonValue::Object: {
+            QJsonObject obj;
+            Utf8View key;
+            beginObject();
+            while (nextMember(&key)) {
+                QString name = QString::fromUtf8(key.data(), key.size());
+                QJsonValue val;
+                if (!readValue(&val)) {
+                    return false;
+                }
+                obj.insert(name, val);
+            }
+            if (!good()) {
+                return false;
+            }
+            *out = obj;
+            break;
+        }
+        case QJsonValue::Array: {
+            QJsonArray arr;
+            beginArray();
+            while (nextElement()) {
+                QJsonValue val;
+                if (!readValue(&val)) {
+                    return false;
+                }
+                arr.append(val);
+            }
+            if (!good()) {
+                return false;
+            }
+            *out = arr;
+            break;
+        }
+        case QJsonValue::String: {
+            QString str;
+            if (!readString(&str)) {
+                return false;
+            }
+            *out = str;
+            break;
+        }
+        case QJsonValue::Double: {
+            double d = 0;
+            if (!readDouble(&d)) {
+                return false;
+            }
+            *out = d;
+            break;
+        }
+        case QJsonValue::Bool: {
+            bool b = false;
+            if (!readBool(&b)) {
+                return false;
+            }
+            *out = b;
+            break;
+        }
+        case QJsonValue::Null: {
+            if (!readNull()) {
+                return false;
+            }
+            *out = QJsonValue(QJsonValue::Null);
+            break;
+        }
+        default:
+            return fail(JsonStream::SyntaxError);
+    }
+    return true;
+}
+
+inline bool JsonReader::readRaw(QByteArray *out) {
+    Utf8View raw;
+    if (!readRaw(&raw)) {
+        return false;
+    }
+    *out = QByteArray(raw.data(), raw.size());
+    return true;
+}
+
+inline bool JsonReader::readRaw(Utf8View *out) {
+    if (peek() == QJsonValue::Undefined) {
+        return fail(JsonStream::SyntaxError);
+    }
+    const char *begin = q_ptr;
+    if (!skipValue() || !checkSize(q_ptr - begin)) {
+        return false;
+    }
+    *out = Utf8View(begin, int(q_ptr - begin));
+    return true;
+}
+
+inline bool JsonReader::skipValue() {
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool flag = false;
+    switch (peek()) {
+        case QJsonValue::Object: {
+            Utf8View key;
+            beginObject();
+            while (nextMember(&key)) {
+                if (!skipValue()) {
+                    return false;
+                }
+            }
+            return good();
+        }
+        case QJsonValue::Array: {
+            beginArray();
+            while (nextElement()) {
+                if (!skipValue()) {
+                    return false;
+                }
+            }
+            return good();
+        }
+        case QJsonValue::String:
+            return scanString(&str, &len, &flag);
+        case QJsonValue::Double:
+            return scanNumber(&str, &len, &flag);
+        case QJsonValue::Bool:
+            return *q_ptr == 't' ? scanLiteral("true", 4) : scanLiteral("false", 5);
+        case QJsonValue::Null:
+            return scanLiteral("null", 4);
+        default:
+            break;
+    }
+    return fail(JsonStream::SyntaxError);
+}
+
+inline void JsonReader::skipSpace() {
+    while (q_ptr != q_end && (*q_ptr == ' ' || *q_ptr == '\n' || *q_ptr == '\r' || *q_ptr == '\t')) {
+        ++q_ptr;
+    }
+}
+
+inline bool JsonReader::fail(JsonStream::Status status) {
+    if (q_status == JsonStream::Ok && status == JsonStream::SyntaxError) {
+        qAsDbg() << "QAS::JsonReader: syntax error at offset " << position();
+    }
+    setStatus(status);
+    return false;
+}
+
+inline bool JsonReader::scanString(const char **str, qint64 *len, bool *escaped) {
+    // Assume the current character is '"'
+    const char *p = q_ptr + 1;
+    bool esc = false;
+    while (p != q_end) {
+        unsigned char c = *p;
+        if (c == '"') {
+            *str = q_ptr + 1;
+            *len = p - *str;
+            *escaped = esc;
+            q_ptr = p + 1;
+            return true;
+        }
+        if (c == '\\') {
+            esc = true;
+            if (++p == q_end) {
+                break;
+            }
+        } else if (c < 0x20) {
+            break;
+        }
+        ++p;
+    }
+    q_ptr = p;
+    return fail(JsonStream::SyntaxError);
+}
+
+inline bool JsonReader::unescape(const char *str, qint64 len, QByteArray *out) {
+    const char *end = str + len;
+    out->clear();
+    out->reserve(int(len));
+
+    auto hex4 = [](const char *p, uint *code) {
+        uint val = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = p[i];
+            val <<= 4;
+            if (c >= '0' && c <= '9') {
+                val |= uint(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                val |= uint(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                val |= uint(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        *code = val;
+        return true;
+    };
+
+    while (str < end) {
+        const char *next = static_cast<const char *>(memchr(str, '\\', size_t(end - str)));
+        if (!next) {
+            out->append(str, int(end - str));
+            break;
+        }
+        out->append(str, int(next - str));
+        str = next + 1;
+
+        switch (*str++) {
+            case '"':
+                out->append('"');
+                break;
+            case '\\':
+                out->append('\\');
+                break;
+            case '/':
+                out->append('/');
+                break;
+            case 'b':
+                out->append('\b');
+                break;
+            case 'f':
+                out->append('\f');
+                break;
+            case 'n':
+                out->append('\n');
+                break;
+            case 'r':
+                out->append('\r');
+                break;
+            case 't':
+                out->append('\t');
+                break;
+            case 'u': {
+                uint code;
+                if (end - str < 4 || !hex4(str, &code)) {
+                    return fail(JsonStream::SyntaxError);
+                }
+                str += 4;
+
+                // Surrogate pair
+                if (code >= 0xD800 && code < 0xDC00) {
+                    uint low;
+                    if (end - str >= 6 && str[0] == '\\' && str[1] == 'u' && hex4(str + 2, &low) &&
+                        low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        str += 6;
+                    } else {
+                        code = 0xFFFD;
+                    }
+                } else if (code >= 0xDC00 && code < 0xE000) {
+                    code = 0xFFFD;
+                }
+
+                // Encode as UTF-8
+                if (code < 0x80) {
+                    out->append(char(code));
+                } else if (code < 0x800) {
+                    out->append(char(0xC0 | (code >> 6)));
+                    out->append(char(0x80 | (code & 0x3F)));
+                } else if (code < 0x10000) {
+                    out->append(char(0xE0 | (code >> 12)));
+                    out->append(char(0x80 | ((code >> 6) & 0x3F)));
+                    out->append(char(0x80 | (code & 0x3F)));
+                } else {
+                    out->append(char(0xF0 | (code >> 18)));
+                    out->append(char(0x80 | ((code >> 12) & 0x3F)));
+                    out->append(char(0x80 | ((code >> 6) & 0x3F)));
+                    out->append(char(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return fail(JsonStream::SyntaxError);
+        }
+    }
+    return true;
+}
+
+inline bool JsonReader::scanNumber(const char **str, qint64 *len, bool *integral) {
+    const char *p = q_ptr;
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+    bool isInt = true;
+    if (*p == '-') {
+        ++p;
+    }
+    if (p == q_end || !isDigit(*p)) {
+        return fail(JsonStream::SyntaxError);
+    }
+    if (*p == '0') {
+        ++p;
+    } else {
+        while (p != q_end && isDigit(*p)) {
+            ++p;
+        }
+    }
+
+    // Fraction
+    if (p != q_end && *p == '.') {
+        isInt = false;
+        ++p;
+        if (p == q_end || !isDigit(*p)) {
+            return fail(JsonStream::SyntaxError);
+        }
+        while (p != q_end && isDigit(*p)) {
+            ++p;
+        }
+    }
+
+    // Exponent
+    if (p != q_end && (*p == 'e' || *p == 'E')) {
+        isInt = false;
+        ++p;
+        if (p != q_end && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+        if (p == q_end || !isDigit(*p)) {
+            return fail(JsonStream::SyntaxError);
+        }
+        while (p != q_end && isDigit(*p)) {
+            ++p;
+        }
+    }
+
+    *str = q_ptr;
+    *len = p - q_ptr;
+    *integral = isInt;
+    q_ptr = p;
+    return true;
+}
+
+inline bool JsonReader::scanLiteral(const char *lit, int len) {
+    if (q_end - q_ptr < len || memcmp(q_ptr, lit, size_t(len)) != 0) {
+        return fail(JsonStream::SyntaxError);
+    }
+    q_ptr += len;
+    return true;
+}
+
+inline bool JsonReader::readMagnitude(quint64 *abs, bool *negative) {
+    QJsonValue::Type type = peek();
+    if (type != QJsonValue::Double) {
+        return fail(type == QJsonValue::Undefined ? JsonStream::SyntaxError : JsonStream::TypeNotMatch);
+    }
+
+    const char *str = nullptr;
+    qint64 len = 0;
+    bool integral = false;
+    if (!scanNumber(&str, &len, &integral) || !checkSize(len)) {
+        return false;
+    }
+    const char *p = str;
+    const char *end = str + len;
+    *negative = *p == '-';
+    if (*negative) {
+        ++p;
+    }
+
+    // Digits go straight into 64 bits, only a 20 digit number can overflow
+    if (integral) {
+        quint64 val = 0;
+        if (end - p < 20) {
+            for (; p < end; ++p) {
+                val = val * 10 + quint64(*p - '0');
+            }
+        } else {
+            for (; p < end; ++p) {
+                const quint64 digit = quint64(*p - '0');
+                if (val > (std::numeric_limits<quint64>::max() - digit) / 10) {
+                    return outOfRange();
+                }
+                val = val * 10 + digit;
+            }
+        }
+        *abs = val;
+        return true;
+    }
+
+    double d = 0;
+    if (!JsonStreamPrivate::parseDouble(str, len, &d)) {
+        return fail(JsonStream::SyntaxError);
+    }
+    d = std::trunc(std::abs(d));
+    if (!(d < 18446744073709551616.0)) {
+        return outOfRange();
+    }
+    *abs = quint64(d);
+    return true;
+}
+
+inline bool JsonReader::outOfRange() {
+    qAsDbg() << "QAS::JsonReader: integer out of range at offset " << position();
+    return fail(JsonStream::TypeNotMatch);
+}
+
+inline bool JsonReader::checkSize(qint64 len) {
+    if (len > JsonStreamPrivate::MaxSize) {
+        qAsDbg() << "QAS::JsonReader: value of " << len << " bytes at offset " << position() << " is too large";
+        return fail(JsonStream::TypeNotMatch);
+    }
+    return true;
+}
+
+inline bool JsonReader::endContainer() {
+    ++q_ptr;
+    --q_depth;
+    q_first = false;
+    return false;
+}
+
+#define QJSONREADER_OUTPUT(VAL, TYPE)                                                                                 \
+    qint64 _l = 0;                                                                                                     \
+    if (readInteger(&_l)) {                                                                                            \
+        if (_l < qint64(std::numeric_limits<TYPE>::min()) || _l > qint64(std::numeric_limits<TYPE>::max())) {         \
+            outOfRange();                                                                                              \
+        } else {                                                                                                       \
+            VAL = TYPE(_l);                                                                                            \
+        }                                                                                                              \
+    }
+
+inline JsonReader &JsonReader::operator>>(qint8 &sc) {
+    QJSONREADER_OUTPUT(sc, qint8);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(quint8 &c) {
+    QJSONREADER_OUTPUT(c, quint8);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(qint16 &s) {
+    QJSONREADER_OUTPUT(s, qint16);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(quint16 &us) {
+    QJSONREADER_OUTPUT(us, quint16);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(qint32 &i) {
+    QJSONREADER_OUTPUT(i, qint32);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(quint32 &u) {
+    QJSONREADER_OUTPUT(u, quint32);
+    return *this;
+}
+
+#undef QJSONREADER_OUTPUT
+
+inline JsonReader &JsonReader::operator>>(qint64 &l) {
+    readInteger(&l);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(quint64 &ul) {
+    readUnsigned(&ul);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(float &f) {
+    double d = 0;
+    if (readDouble(&d)) {
+        f = float(d);
+    }
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(double &d) {
+    readDouble(&d);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(bool &b) {
+    readBool(&b);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(QString &s) {
+    if (q_validateOnly) {
+        Utf8View str;
+        readString(&str);
+        return *this;
+    }
+    readString(&s);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(QJsonValue &val) {
+    if (q_validateOnly) {
+        Utf8View raw;
+        readRaw(&raw);
+        return *this;
+    }
+    readValue(&val);
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(QJsonArray &arr) {
+    if (peek() != QJsonValue::Array) {
+        fail(JsonStream::TypeNotMatch);
+        return *this;
+    }
+    if (q_validateOnly) {
+        skipValue();
+        return *this;
+    }
+    QJsonValue val;
+    if (readValue(&val)) {
+        arr = val.toArray();
+    }
+    return *this;
+}
+
+inline JsonReader &JsonReader::operator>>(QJsonObject &obj) {
+    if (peek() != QJsonValue::Object) {
+        fail(JsonStream::TypeNotMatch);
+        return *this;
+    }
+    if (q_validateOnly) {
+        skipValue();
+        return *this;
+    }
+    QJsonValue val;
+    if (readValue(&val)) {
+        obj = val.toObject();
+    }
+    return *this;
+}
+
+// ----------------------------------
+// User Implementation Part
+// ----------------------------------
+
+/* Fallback for classes which only have JsonStream implementations */
+template <class T>
+JsonReader &operator>>(JsonReader &reader, T &var) {
+    QJsonValue val;
+    if (!reader.readValue(&val)) {
+        return reader;
+    }
+    JsonStream stream(val);
+    stream >> var;
+    reader.setStatus(stream.status());
+    return reader;
+}
+
+// ----------------------------------
+// Private Part
+// ----------------------------------
+
+namespace JsonReaderUtils {
+
+    inline bool parseAsObject(JsonReader &reader, const char *typeName) {
+        QJsonValue::Type type = reader.peek();
+        if (type != QJsonValue::Object && type != QJsonValue::Undefined) {
+            qAsDbg() << typeName << ": expect object, but get " << type;
+        }
+        return reader.beginObject();
+    }
+
+    inline bool parseAsArray(JsonReader &reader, const char *typeName) {
+        QJsonValue::Type type = reader.peek();
+        if (type != QJsonValue::Array && type != QJsonValue::Undefined) {
+            qAsDbg() << typeName << ": expect array, but get " << type;
+        }
+        return reader.beginArray();
+    }
+
+    inline bool parseAsString(JsonReader &reader, const char *typeName, QString *out) {
+        QJsonValue::Type type = reader.peek();
+        if (type != QJsonValue::String && type != QJsonValue::Undefined) {
+            qAsDbg() << typeName << ": expect string, but get " << type;
+        }
+        return reader.readString(out);
+    }
+
+    inline bool parseAsString(JsonReader &reader, const char *typeName, Utf8View *out) {
+        QJsonValue::Type type = reader.peek();
+        if (type != QJsonValue::String && type != QJsonValue::Undefined) {
+            qAsDbg() << typeName << ": expect string, but get " << type;
+        }
+        return reader.readString(out);
+    }
+
+    template <class T>
+    bool parseObjectMember(JsonReader &reader, const char *key, const char *typeName, T *out) {
+        if (reader.mask().isFull()) {
+            reader >> *out;
+        } else {
+            const FieldMask::Cursor mask = reader.mask();
+            reader.setMask(mask.child(Utf8View(key)));
+            reader >> *out;
+            reader.setMask(mask);
+        }
+
+        // If failed
+        if (!reader.good()) {
+            qAsDbg() << typeName << ": fail at key " << key;
+            return false;
+        }
+        return true;
+    }
+
+    // Constraints check the value, so it's decoded even if the reader only validates
+    template <class T>
+    bool parseConstrainedMember(JsonReader &reader, const char *key, const char *typeName, T *out) {
+        const bool validateOnly = reader.validateOnly();
+        reader.setValidateOnly(false);
+        bool res = parseObjectMember(reader, key, typeName, out);
+        reader.setValidateOnly(validateOnly);
+        return res;
+    }
+
+    using ReaderUtils::DerivedClass;
+    using ReaderUtils::derivedClass;
+
+    // Polymorphic pointer, the member key holds the type, a reader of the rest of the input scans the object
+    // up to it and the concrete class then reads the object from the start
+    template <class BASE, class TYPE, class... CLASSES>
+    JsonReader &parsePolymorphic(JsonReader &reader, QSharedPointer<BASE> &var, const char *key,
+                                 const char *typeName, TYPE BASE::*member, CLASSES... classes) {
+        JsonReader scan = reader.slice(reader.position(), reader.size());
+        scan.setValidateOnly(false);
+        scan.setMask(FieldMask::Cursor());
+        if (!parseAsObject(scan, typeName)) {
+            reader.setStatus(scan.status());
+            return reader;
+        }
+
+        TYPE type{};
+        bool found = false;
+        Utf8View name;
+        while (!found && scan.nextMember(&name)) {
+            if (name == Utf8View(key)) {
+                found = parseObjectMember(scan, key, typeName, &type);
+            } else if (!scan.skipValue()) {
+                break;
+            }
+        }
+        if (!scan.good()) {
+            reader.setStatus(scan.status());
+            return reader;
+        }
+        if (!found) {
+            reader.setStatus(JsonStream::KeyNotFound);
+            return reader;
+        }
+        return ReaderUtils::parseDerived(reader, var, member, type, classes...);
+    }
+
+}
+
+// ----------------------------------
+// Supported Containers
+// ----------------------------------
+
+namespace JsonReaderContainers {
+
+    using JsonStreamContainers::append;
+
+    // List Implementations
+    template <class LIST>
+    JsonReader &writeList(JsonReader &reader, LIST &list) {
+        // Check type
+        if (!JsonReaderUtils::parseAsArray(reader, QAS_TYPE_NAME(list))) {
+            return reader;
+        }
+        if (reader.validateOnly()) {
+            return ReaderContainers::checkList(reader, list);
+        }
+        if (reader.inPlace()) {
+            return ReaderContainers::updateList(
+                    reader, list, std::integral_constant<bool, ReaderContainers::IsUpdatable<LIST>::value>());
+        }
+
+        // Write
+        LIST tmpList;
+        int index = 0;
+        while (reader.nextElement()) {
+            if (JsonStreamPrivate::IsParallel<typename LIST::value_type>::value && reader.threadPool() &&
+                index == reader.parallelThreshold()) {
+                return ReaderContainers::writeParallel(reader, list, tmpList, index);
+            }
+            typename LIST::value_type tmp{};
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
+                return reader;
+            }
+
+            append(tmpList, std::move(tmp));
+            ++index;
+        }
+        if (reader.good()) {
+            list = std::move(tmpList);
+        }
+        return reader;
+    }
+
+    // Map Implementations
+    template <class MAP, class OP>
+    JsonReader &writeMap(JsonReader &reader, MAP &map, OP op) {
+        // Check type
+        if (!JsonReaderUtils::parseAsObject(reader, QAS_TYPE_NAME(map))) {
+            return reader;
+        }
+        if (reader.validateOnly()) {
+            return ReaderContainers::checkMap(reader, map);
+        }
+        if (reader.inPlace()) {
+            return ReaderContainers::updateMap(reader, map, op);
+        }
+        MAP tmpMap;
+
+        Utf8View key;
+        while (reader.nextMember(&key)) {
+            // Keys are only valid until next member
+            QString name = QString::fromUtf8(key.data(), key.size());
+            typename MAP::mapped_type tmp{};
+
+            reader >> tmp;
+            if (!reader.good()) {
+                qAsDbg() << QAS_TYPE_NAME(map) << ": fail at key " << name;
+                return reader;
+            }
+
+            // Use operator to insert
+            op.insert(tmpMap, std::move(name), std::move(tmp));
+        }
+        if (reader.good()) {
+            map = std::move(tmpMap);
+        }
+        return reader;
+    }
+
+}
+
+// std::vector
+template <class T>
+JsonReader &operator>>(JsonReader &reader, std::vector<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+// std::list
+template <class T>
+JsonReader &operator>>(JsonReader &reader, std::list<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+// std::set
+template <class T>
+JsonReader &operator>>(JsonReader &reader, std::set<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+// QList
+template <class T>
+JsonReader &operator>>(JsonReader &reader, QList<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+#endif
+
+// QSet
+template <class T>
+JsonReader &operator>>(JsonReader &reader, QSet<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+// QVector
+template <class T>
+JsonReader &operator>>(JsonReader &reader, QVector<T> &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+// QStringList
+inline JsonReader &operator>>(JsonReader &reader, QStringList &list) {
+    return QAS::JsonReaderContainers::writeList(reader, list);
+}
+
+// std::map
+template <class T>
+JsonReader &operator>>(JsonReader &reader, std::map<QString, T> &map) {
+    return QAS::JsonReaderContainers::writeMap(reader, map, STLMapOps());
+}
+
+// std::unordered_map
+template <class T>
+JsonReader &operator>>(JsonReader &reader, std::unordered_map<QString, T> &map) {
+    return QAS::JsonReaderContainers::writeMap(reader, map, STLMapOps());
+}
+
+// QMap
+template <class T>
+JsonReader &operator>>(JsonReader &reader, QMap<QString, T> &map) {
+    return QAS::JsonReaderContainers::writeMap(reader, map, QtMapOps());
+}
+
+// QHash
+template <class T>
+JsonReader &operator>>(JsonReader &reader, QHash<QString, T> &map) {
+    return QAS::JsonReaderContainers::writeMap(reader, map, QtMapOps());
+}
+
+QAS_END_NAMESPACE
+
+// ----------------------------------
+// Simplified Macros or Functions
+// ----------------------------------
+
+// UTF-8 Json Text -> Non-Basic Class
+template <class T>
+bool qAsJsonTryParseClass(const QByteArray &data, T *out) {
+    QAS::JsonReader reader(data);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::JsonReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsJsonParseClass(const QByteArray &data) {
+    T tmp{};
+    qAsJsonTryParseClass(data, &tmp);
+    return tmp;
+}
+
+// UTF-8 Json Text -> Existing Non-Basic Class, reusing its storage and partially updated on failure
+template <class T>
+bool qAsJsonTryUpdateClass(const QByteArray &data, T *out) {
+    QAS::JsonReader reader(data);
+    reader.setInPlace(true);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::JsonReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+// UTF-8 Json Text -> Non-Basic Class, reading only the members selected by the mask
+template <class T>
+bool qAsJsonTryGetClassPartial(const QByteArray &data, const QAS::FieldMask &mask, T *out) {
+    QAS::JsonReader reader(data);
+    reader.setMask(&mask);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::JsonReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsJsonGetClassPartial(const QByteArray &data, const QAS::FieldMask &mask) {
+    T tmp{};
+    qAsJsonTryGetClassPartial(data, mask, &tmp);
+    return tmp;
+}
+
+// UTF-8 Json Text -> Check against Non-Basic Class, nothing is kept and member storage isn't allocated
+template <class T>
+bool qAsJsonValidate(const QByteArray &data, QAS::JsonStream::Status *status = nullptr) {
+    QAS::JsonReader reader(data);
+    reader.setValidateOnly(true);
+    T tmp{};
+    reader >> tmp;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::JsonReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    if (status) {
+        *status = reader.status();
+    }
+    return reader.good();
+}
+
+// UTF-8 Json File -> Non-Basic Class, the file is mapped and parsed from the mapping instead of being read into memory
+template <class T>
+bool qAsJsonTryLoadFile(const QString &path, T *out) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qAsDbg() << "QAS::JsonReader: failed to open " << path;
+        return false;
+    }
+    QByteArray buf;
+    const char *data = nullptr;
+    qint64 size = 0;
+    QAS::ReaderUtils::mapFile(file, &buf, &data, &size);
+
+    // Nothing read keeps a view into the mapping, it's released with the file
+    QAS::JsonReader reader(data, size);
+    reader >> *out;
+    if (reader.good() && !reader.atEnd()) {
+        qAsDbg() << "QAS::JsonReader: unexpected data after value at offset " << reader.position();
+        reader.setStatus(QAS::JsonStream::SyntaxError);
+    }
+    return reader.good();
+}
+
+template <class T>
+T qAsJsonLoadFile(const QString &path) {
+    T tmp{};
+    qAsJsonTryLoadFile(path, &tmp);
+    return tmp;
+}
+
+#endif // QJSONREADER_H
@@ -27,12 +27,22 @@
 #include <QHash>
 #include <QList>
 #include <QMap>
+#include <QRunnable>
+#include <QSemaphore>
 #include <QSet>
+#include <QStringList>
+#include <QThreadPool>
 #include <QVector>
 
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <new>
 #include <set>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -40,6 +50,11 @@
 
 QAS_BEGIN_NAMESPACE
 
+class JsonReader;
+class JsonWriter;
+class CborReader;
+class CborWriter;
+
 class JsonStream {
 public:
     enum Status {
@@ -48,8 +63,9 @@ public:
         TypeNotMatch = 4,
         UnlistedValue = 8,
         ConstraintViolation = 16,  // Value violates constraint rules
+        SyntaxError = 32,          // Input is not valid json text
         Success = Ok,
-        Failed = KeyNotFound | UnlistedValue | TypeNotMatch | ConstraintViolation,
+        Failed = KeyNotFound | UnlistedValue | TypeNotMatch | ConstraintViolation | SyntaxError,
     };
 
     JsonStream() : q_status(Ok){};
@@ -240,43 +256,58 @@ inline void JsonStream::resetStatus() {
 
 #define QJSONSTREAM_OUTPUT(VAL, TYPE) setStatus(q_val.is##TYPE() ? (VAL = q_val.to##TYPE(), Ok) : TypeNotMatch)
 
+// Integers must fit into the type like JsonReader, the upper bound is exclusive so that 2^63 and 2^64 are rejected
+#define QJSONSTREAM_INTEGER_OUTPUT(VAL, TYPE)                                                                          \
+    if (!q_val.isDouble()) {                                                                                           \
+        setStatus(TypeNotMatch);                                                                                       \
+    } else {                                                                                                           \
+        double _d = q_val.toDouble();                                                                                  \
+        if (!(_d >= double(std::numeric_limits<TYPE>::min()) &&                                                        \
+              _d < double(std::numeric_limits<TYPE>::max()) + 1.0)) {                                                  \
+            qAsDbg() << "QAS::JsonStream: integer out of range " << _d;                                                \
+            setStatus(TypeNotMatch);                                                                                   \
+        } else {                                                                                                       \
+            VAL = TYPE(_d);                                                                                            \
+        }                                                                                                              \
+    }
+
 inline JsonStream &JsonStream::operator>>(qint8 &sc) {
-    QJSONSTREAM_OUTPUT(sc, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(sc, qint8);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(quint8 &c) {
-    QJSONSTREAM_OUTPUT(c, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(c, quint8);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(qint16 &s) {
-    QJSONSTREAM_OUTPUT(s, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(s, qint16);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(quint16 &us) {
-    QJSONSTREAM_OUTPUT(us, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(us, quint16);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(qint32 &i) {
-    QJSONSTREAM_OUTPUT(i, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(i, qint32);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(quint32 &u) {
-    QJSONSTREAM_OUTPUT(u, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(u, quint32);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(qint64 &l) {
-    QJSONSTREAM_OUTPUT(l, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(l, qint64);
     return *this;
 }
 
 inline JsonStream &JsonStream::operator>>(quint64 &ul) {
-    QJSONSTREAM_OUTPUT(ul, Double);
+    QJSONSTREAM_INTEGER_OUTPUT(ul, quint64);
     return *this;
 }
 
@@ -301,7 +332,7 @@ inline JsonStream &JsonStream::operator>>(QString &s) {
 }
 
 inline JsonStream &JsonStream::operator>>(QJsonValue &val) {
-    q_val = val;
+    val = q_val;
     return *this;
 }
 
@@ -316,6 +347,7 @@ inline JsonStream &JsonStream::operator>>(QJsonObject &obj) {
 }
 
 #undef QJSONSTREAM_OUTPUT
+#undef QJSONSTREAM_INTEGER_OUTPUT
 
 #define QJSONSTREAM_INPUT(VALUE)                                                                                       \
     q_val = QJsonValue(VALUE);                                                                                         \
@@ -357,7 +389,12 @@ inline JsonStream &JsonStream::operator<<(qint64 l) {
 }
 
 inline JsonStream &JsonStream::operator<<(quint64 ul) {
-    QJSONSTREAM_INPUT((qint64) ul);
+    // Values beyond qint64 are kept as double instead of wrapping around
+    if (ul > quint64(std::numeric_limits<qint64>::max())) {
+        QJSONSTREAM_INPUT(double(ul));
+    } else {
+        QJSONSTREAM_INPUT(qint64(ul));
+    }
     return *this;
 }
 
@@ -396,6 +433,167 @@ inline JsonStream &JsonStream::operator<<(const QJsonObject &obj) {
     return *this;
 }
 
+// ----------------------------------
+// UTF-8 View
+// ----------------------------------
+
+/**
+ * Utf8View refers to UTF-8 bytes it doesn't own, the keys and strings returned by the streaming
+ * readers and the keys written by the generated code. QLatin1String is only used for Latin-1 text.
+ *
+ */
+
+class Utf8View {
+public:
+    constexpr Utf8View() : q_data(nullptr), q_size(0) {
+    }
+    constexpr Utf8View(const char *data, int size) : q_data(data), q_size(size) {
+    }
+    explicit Utf8View(const char *str) : q_data(str), q_size(str ? int(strlen(str)) : 0) {
+    }
+
+    inline const char *data() const {
+        return q_data;
+    }
+
+    inline int size() const {
+        return q_size;
+    }
+
+    inline bool isEmpty() const {
+        return q_size == 0;
+    }
+
+    inline QString toString() const {
+        return QString::fromUtf8(q_data, q_size);
+    }
+
+    friend inline bool operator==(Utf8View a, Utf8View b) {
+        return a.q_size == b.q_size && (a.q_size == 0 || memcmp(a.q_data, b.q_data, size_t(a.q_size)) == 0);
+    }
+
+    friend inline bool operator!=(Utf8View a, Utf8View b) {
+        return !(a == b);
+    }
+
+private:
+    const char *q_data;
+    int q_size;
+};
+
+// ----------------------------------
+// Field Mask
+// ----------------------------------
+
+/**
+ * FieldMask selects the members read by the streaming readers with dotted key paths, "a.b"
+ * selects the member b of the object in a, "a" selects a as a whole. Lists and maps are
+ * transparent, the path continues with the members of their elements.
+ *
+ * Members not selected are skipped without building values, and aren't reported if missing.
+ *
+ */
+
+class FieldMask {
+public:
+    FieldMask();
+    FieldMask(const QStringList &paths);
+
+    void add(const QString &path);
+
+    // Position of a reader in the mask
+    class Cursor {
+    public:
+        inline Cursor(const FieldMask *mask = nullptr) : q_mask(mask), q_node(mask ? 0 : All) {
+        }
+
+        /* Every member below is selected */
+        inline bool isFull() const {
+            return q_node == All;
+        }
+
+        bool contains(Utf8View key) const;
+        Cursor child(Utf8View key) const;
+
+    private:
+        enum {
+            All = -1,
+            None = -2,
+        };
+
+        inline Cursor(const FieldMask *mask, int node) : q_mask(mask), q_node(node) {
+        }
+
+        const FieldMask *q_mask;
+        int q_node;
+    };
+
+private:
+    struct Node {
+        QByteArray key;
+        QVector<int> children; // Indexes of the child nodes, a lookup only compares the keys of one node
+        bool all;
+    };
+    QVector<Node> q_nodes; // The first one is the root
+
+    int find(int parent, const char *key, int size) const;
+};
+
+inline FieldMask::FieldMask() {
+    q_nodes.append({QByteArray(), {}, false});
+}
+
+inline FieldMask::FieldMask(const QStringList &paths) : FieldMask() {
+    for (const auto &path : paths) {
+        add(path);
+    }
+}
+
+inline void FieldMask::add(const QString &path) {
+    int node = 0;
+    for (const auto &key : path.toUtf8().split('.')) {
+        if (q_nodes.at(node).all) {
+            return;
+        }
+        int next = find(node, key.constData(), key.size());
+        if (next < 0) {
+            next = q_nodes.size();
+            q_nodes.append({key, {}, false});
+            q_nodes[node].children.append(next);
+        }
+        node = next;
+    }
+    q_nodes[node].all = true;
+}
+
+inline int FieldMask::find(int parent, const char *key, int size) const {
+    for (int i : q_nodes.at(parent).children) {
+        const Node &node = q_nodes.at(i);
+        if (node.key.size() == size && memcmp(node.key.constData(), key, size) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+inline bool FieldMask::Cursor::contains(Utf8View key) const {
+    if (q_node < 0) {
+        return q_node == All;
+    }
+    return q_mask->find(q_node, key.data(), key.size()) >= 0;
+}
+
+inline FieldMask::Cursor FieldMask::Cursor::child(Utf8View key) const {
+    if (q_node < 0) {
+        return *this;
+    }
+    int node = q_mask->find(q_node, key.data(), key.size());
+    if (node < 0) {
+        return Cursor(q_mask, None);
+    }
+    return Cursor(q_mask, q_mask->q_nodes.at(node).all ? int(All) : node);
+}
+
 #ifdef QAS_JSON_ENABLE_DECLARE_EVERYWHERE
 // ----------------------------------
 // User Implementation Part
@@ -471,6 +669,204 @@ namespace JsonStreamPrivate {
     QAS_JSON_PRIVATE_DECLARE_CONVERTER(String)
 
 #undef QAS_JSON_PRIVATE_DECLARE_CONVERTER
+
+    // Object filled by a generated reader, the target itself in place mode, otherwise a temporary
+    // which replaces the target only after a successful read
+    template <class T>
+    class UpdateTarget {
+    public:
+        UpdateTarget(T &var, bool inPlace) : q_var(var), q_ptr(&var) {
+            if (!inPlace) {
+                q_ptr = new (q_buf) T{};
+            }
+        }
+
+        ~UpdateTarget() {
+            if (q_ptr != &q_var) {
+                q_ptr->~T();
+            }
+        }
+
+        inline T &get() {
+            return *q_ptr;
+        }
+
+        void commit() {
+            if (q_ptr != &q_var) {
+                q_var = std::move(*q_ptr);
+            }
+        }
+
+    private:
+        T &q_var;
+        T *q_ptr;
+        alignas(T) char q_buf[sizeof(T)];
+
+        Q_DISABLE_COPY_MOVE(UpdateTarget)
+    };
+
+    // Offsets into the input and output are 64-bit, but a string or a block of bytes must still fit into a Qt 5
+    // container
+    enum {
+        MaxSize = INT_MAX,
+    };
+
+    // Json number text checked by the reader
+    inline bool parseDouble(const char *str, qint64 len, double *out) {
+#ifdef QAS_HAS_TO_CHARS
+        // Values out of range of double are left to Qt as before
+        const std::from_chars_result res = std::from_chars(str, str + len, *out);
+        if (res.ec == std::errc() && res.ptr == str + len) {
+            return true;
+        }
+#endif
+        bool ok;
+        *out = QByteArray::fromRawData(str, int(len)).toDouble(&ok);
+        return ok;
+    }
+
+#ifdef QAS_HAS_TO_CHARS
+    // Shortest digits that read back to the same double, laid out as QByteArray::number(d, fixed ? 'f' : 'g',
+    // QLocale::FloatingPointShortest) does, which QJsonDocument uses, out must hold 32 bytes
+    inline int formatDouble(double d, bool fixed, char *out) {
+        char sci[32];
+        const char *end = std::to_chars(sci, sci + sizeof(sci), d, std::chars_format::scientific).ptr;
+        const char *p = sci;
+        char *o = out;
+        if (*p == '-') {
+            *o++ = '-';
+            ++p;
+        }
+
+        // [d][.ddd]e[+-]dd
+        char digits[24];
+        int count = 0;
+        for (; p < end && *p != 'e'; ++p) {
+            if (*p != '.') {
+                digits[count++] = *p;
+            }
+        }
+        int exp = 0;
+        const bool negativeExp = p + 1 < end && p[1] == '-';
+        for (p += 2; p < end; ++p) {
+            exp = exp * 10 + (*p - '0');
+        }
+        if (negativeExp) {
+            exp = -exp;
+        }
+
+        // The exponent form adds "e", a sign and two digits, the shorter form is used
+        const int decpt = exp + 1;
+        const bool useDecimal = fixed || (decpt > 0 ? decpt <= count + 4 : 1 - decpt <= 4);
+        if (!useDecimal) {
+            *o++ = digits[0];
+            if (count > 1) {
+                *o++ = '.';
+                memcpy(o, digits + 1, size_t(count - 1));
+                o += count - 1;
+            }
+            *o++ = 'e';
+            *o++ = exp < 0 ? '-' : '+';
+            const int absExp = exp < 0 ? -exp : exp;
+            if (absExp >= 100) {
+                *o++ = char('0' + absExp / 100);
+            }
+            *o++ = char('0' + absExp / 10 % 10);
+            *o++ = char('0' + absExp % 10);
+        } else if (decpt <= 0) {
+            *o++ = '0';
+            *o++ = '.';
+            for (int i = decpt; i < 0; ++i) {
+                *o++ = '0';
+            }
+            memcpy(o, digits, size_t(count));
+            o += count;
+        } else if (decpt >= count) {
+            memcpy(o, digits, size_t(count));
+            o += count;
+            for (int i = count; i < decpt; ++i) {
+                *o++ = '0';
+            }
+        } else {
+            memcpy(o, digits, size_t(decpt));
+            o += decpt;
+            *o++ = '.';
+            memcpy(o, digits + decpt, size_t(count - decpt));
+            o += count - decpt;
+        }
+        return int(o - out);
+    }
+#endif
+
+    // Decode UTF-8 into an existing string, ASCII text reuses its buffer when it's large enough
+    inline void assignUtf8(QString *out, const char *str, qint64 len, bool inPlace) {
+        if (inPlace && out->isDetached() && out->capacity() >= len) {
+            qint64 i = 0;
+            while (i < len && uchar(str[i]) < 0x80) {
+                ++i;
+            }
+            if (i == len) {
+                out->resize(int(len));
+                QChar *dst = out->data();
+                for (i = 0; i < len; ++i) {
+                    dst[i] = QLatin1Char(str[i]);
+                }
+                return;
+            }
+        }
+        *out = QString::fromUtf8(str, int(len));
+    }
+
+    // Numbers are cheaper to convert than to hand over to another thread
+    template <class T>
+    struct IsParallel {
+        static const bool value = !std::is_arithmetic<T>::value;
+    };
+
+    template <class Func>
+    class RangeTask : public QRunnable {
+    public:
+        RangeTask(const Func &func, int begin, int end, QSemaphore *done)
+            : q_func(func), q_begin(begin), q_end(end), q_done(done) {
+            setAutoDelete(false);
+        }
+
+        void run() override {
+            q_func(q_begin, q_end);
+            q_done->release();
+        }
+
+    private:
+        const Func &q_func;
+        int q_begin;
+        int q_end;
+        QSemaphore *q_done;
+    };
+
+    // Calls func(begin, end) for consecutive ranges of [0, count) on the pool and returns when all
+    // are done, the calling thread takes back the ranges not started yet so nested calls can't starve
+    template <class Func>
+    void runParallel(QThreadPool *pool, int count, int chunk, const Func &func) {
+        if (!pool || count <= chunk) {
+            func(0, count);
+            return;
+        }
+
+        QSemaphore done;
+        std::vector<std::unique_ptr<RangeTask<Func>>> tasks;
+        for (int begin = chunk; begin < count; begin += chunk) {
+            tasks.emplace_back(new RangeTask<Func>(func, begin, qMin(begin + chunk, count), &done));
+            pool->start(tasks.back().get());
+        }
+
+        func(0, chunk);
+        for (const auto &task : tasks) {
+            if (pool->tryTake(task.get())) {
+                task->run();
+            }
+        }
+        done.acquire(int(tasks.size()));
+    }
 }
 
 #define QAS_JSON_FROM_VALUE_IMPL(VAL)  QAS::JsonStreamPrivate::JsonValueConverter(VAL)
@@ -479,7 +875,7 @@ namespace JsonStreamPrivate {
 
 namespace JsonStreamUtils {
 
-    inline JsonStream &parseAsArray(JsonStream &stream, const QByteArray &typeName, QJsonArray *out) {
+    inline JsonStream &parseAsArray(JsonStream &stream, const char *typeName, QJsonArray *out) {
         stream.resetStatus();
         const QJsonValue &_data = stream.data();
         if (!_data.isArray()) {
@@ -491,7 +887,7 @@ namespace JsonStreamUtils {
         return stream;
     }
 
-    inline JsonStream &parseAsObject(JsonStream &stream, const QByteArray &typeName, QJsonObject *out) {
+    inline JsonStream &parseAsObject(JsonStream &stream, const char *typeName, QJsonObject *out) {
         stream.resetStatus();
         const QJsonValue &_data = stream.data();
         if (!_data.isObject()) {
@@ -503,7 +899,7 @@ namespace JsonStreamUtils {
         return stream;
     }
 
-    inline JsonStream &parseAsString(JsonStream &stream, const QByteArray &typeName, QString *out) {
+    inline JsonStream &parseAsString(JsonStream &stream, const char *typeName, QString *out) {
         stream.resetStatus();
         const QJsonValue &_data = stream.data();
         if (!_data.isString()) {
@@ -515,8 +911,10 @@ namespace JsonStreamUtils {
         return stream;
     }
 
+    // Deprecated, kept for hand-written deserializers, the generated ones walk the object once and read each
+    // member with parseMemberValue() instead of building a key and searching the object per member
     template <class T>
-    JsonStream parseObjectMember(const QJsonObject &obj, const QByteArray &key, const QByteArray &typeName, T *out) {
+    JsonStream parseObjectMember(const QJsonObject &obj, const QByteArray &key, const char *typeName, T *out) {
         auto it = obj.find(key);
         QAS::JsonStream tmpStream;
         if (it != obj.end()) {
@@ -534,6 +932,18 @@ namespace JsonStreamUtils {
         return tmpStream;
     };
 
+    template <class T>
+    JsonStream parseMemberValue(const QJsonValue &val, const char *key, const char *typeName, T *out) {
+        QAS::JsonStream tmpStream(val);
+        tmpStream >> *out;
+
+        // If failed
+        if (!tmpStream.good()) {
+            qAsDbg() << typeName << ": fail at key " << key;
+        }
+        return tmpStream;
+    };
+
 }
 
 // ----------------------------------
@@ -542,29 +952,57 @@ namespace JsonStreamUtils {
 
 namespace JsonStreamContainers {
 
+    template <class LIST, class T>
+    void append(LIST &list, T &&item) {
+        list.insert(list.end(), std::forward<T>(item));
+    }
+
+    template <class T, class U>
+    void append(QSet<T> &list, U &&item) {
+        list.insert(std::forward<U>(item));
+    }
+
+    template <class LIST>
+    auto reserveImpl(LIST &list, int size, int) -> decltype(list.reserve(size), void()) {
+        list.reserve(size);
+    }
+
+    template <class LIST>
+    void reserveImpl(LIST &, int, long) {
+    }
+
+    // Lists and maps without reserve() are left as they are
+    template <class LIST>
+    void reserve(LIST &list, int size) {
+        reserveImpl(list, size, 0);
+    }
+
     // List Implementations
     template <class LIST>
     JsonStream &writeList(JsonStream &stream, LIST &list) {
         // Check type
         QJsonArray arr;
-        if (!JsonStreamUtils::parseAsArray(stream, typeid(list).name(), &arr).good()) {
+        if (!JsonStreamUtils::parseAsArray(stream, QAS_TYPE_NAME(list), &arr).good()) {
             return stream;
         }
 
         // Write
         LIST tmpList;
+        reserve(tmpList, arr.size());
+        int index = 0;
         for (const auto &item : qAsConst(arr)) {
             JsonStream tmpStream(item);
-            typename LIST::value_type tmp;
+            typename LIST::value_type tmp{};
 
             tmpStream >> tmp;
             if (!tmpStream.good()) {
-                qAsDbg() << typeid(list).name() << ": fail at index " << list.size();
+                qAsDbg() << QAS_TYPE_NAME(list) << ": fail at index " << index;
                 stream.setStatus(tmpStream.status());
                 return stream;
             }
 
-            tmpList.append(tmp);
+            append(tmpList, std::move(tmp));
+            ++index;
         }
         list = std::move(tmpList);
         return stream;
@@ -574,9 +1012,10 @@ namespace JsonStreamContainers {
     JsonStream &readList(JsonStream &stream, const LIST &list) {
         stream.resetStatus();
 
+        // QJsonArray can't reserve, append the values directly without another array copy
         QJsonArray arr;
         for (const auto &item : qAsConst(list)) {
-            arr += JsonStream::fromValue(item).data();
+            arr.append(JsonStream::fromValue(item).data());
         }
         stream << arr;
 
@@ -588,25 +1027,26 @@ namespace JsonStreamContainers {
     JsonStream &writeMap(JsonStream &stream, MAP &map, OP op) {
         // Check type
         QJsonObject obj;
-        if (!JsonStreamUtils::parseAsObject(stream, typeid(map).name(), &obj).good()) {
+        if (!JsonStreamUtils::parseAsObject(stream, QAS_TYPE_NAME(map), &obj).good()) {
             return stream;
         }
         MAP tmpMap;
+        reserve(tmpMap, obj.size());
 
-        for (auto it = obj.begin(); it != obj.end(); ++it) {
+        for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
             // Use operator to get key-value pair
             JsonStream tmpStream(it.value());
-            typename MAP::mapped_type tmp;
+            typename MAP::mapped_type tmp{};
 
             tmpStream >> tmp;
             if (!tmpStream.good()) {
-                qAsDbg() << typeid(map).name() << ": fail at key " << it.key();
+                qAsDbg() << QAS_TYPE_NAME(map) << ": fail at key " << it.key();
                 stream.setStatus(tmpStream.status());
                 return stream;
             }
 
             // Use operator to insert
-            op.insert(tmpMap, it.key(), tmp);
+            op.insert(tmpMap, it.key(), std::move(tmp));
         }
 
         map = std::move(tmpMap);
@@ -620,9 +1060,8 @@ namespace JsonStreamContainers {
         QJsonObject obj;
 
         for (auto it = map.begin(); it != map.end(); ++it) {
-            // Use operator to get key-value pair
-            QPair<QString, typename MAP::mapped_type> pair = op.template KVPair<QString, typename MAP::mapped_type>(it);
-            obj.insert(pair.first, JsonStream::fromValue(pair.second).data());
+            // Use operator to get key and value without copying them
+            obj.insert(op.key(it), JsonStream::fromValue(op.value(it)).data());
         }
 
         stream << obj;
@@ -716,8 +1155,18 @@ struct STLMapOps {
     }
 
     template <class MAP, class K, class V>
-    void insert(MAP &map, const K &key, const V &value) const {
-        map.insert(std::make_pair(key, value));
+    void insert(MAP &map, K &&key, V &&value) const {
+        map.emplace(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    template <class IT>
+    auto key(const IT &it) const -> decltype((it->first)) {
+        return it->first;
+    }
+
+    template <class IT>
+    auto value(const IT &it) const -> decltype((it->second)) {
+        return it->second;
     }
 };
 
@@ -751,8 +1200,19 @@ struct QtMapOps {
     }
 
     template <class MAP, class K, class V>
-    void insert(MAP &map, const K &key, const V &value) const {
-        map.insert(key, value);
+    void insert(MAP &map, K &&key, V &&value) const {
+        // Qt 5 containers have no rvalue insert, assigning moves the value
+        map[std::forward<K>(key)] = std::forward<V>(value);
+    }
+
+    template <class IT>
+    auto key(const IT &it) const -> decltype(it.key()) {
+        return it.key();
+    }
+
+    template <class IT>
+    auto value(const IT &it) const -> decltype(it.value()) {
+        return it.value();
     }
 };
 
@@ -788,6 +1248,26 @@ QAS_END_NAMESPACE
     QAS::JsonStream &operator>>(QAS::JsonStream &stream, TYPE &var);                                                   \
     QAS::JsonStream &operator<<(QAS::JsonStream &stream, const TYPE &var);
 
+#define QAS_JSON_READER_IMPL(TYPE)                                                                                     \
+    friend QAS::JsonReader &operator>>(QAS::JsonReader &reader, TYPE &var);
+
+#define QAS_JSON_NS_READER_IMPL(TYPE)                                                                                  \
+    QAS::JsonReader &operator>>(QAS::JsonReader &reader, TYPE &var);
+
+#define QAS_JSON_WRITER_IMPL(TYPE)                                                                                     \
+    friend QAS::JsonWriter &operator<<(QAS::JsonWriter &writer, const TYPE &var);
+
+#define QAS_JSON_NS_WRITER_IMPL(TYPE)                                                                                  \
+    QAS::JsonWriter &operator<<(QAS::JsonWriter &writer, const TYPE &var);
+
+#define QAS_JSON_CBOR_IMPL(TYPE)                                                                                       \
+    friend QAS::CborReader &operator>>(QAS::CborReader &reader, TYPE &var);                                            \
+    friend QAS::CborWriter &operator<<(QAS::CborWriter &writer, const TYPE &var);
+
+#define QAS_JSON_NS_CBOR_IMPL(TYPE)                                                                                    \
+    QAS::CborReader &operator>>(QAS::CborReader &reader, TYPE &var);                                                   \
+    QAS::CborWriter &operator<<(QAS::CborWriter &writer, const TYPE &var);
+
 // ----------------------------------
 // QASC Macros
 // ----------------------------------
@@ -795,8 +1275,9 @@ QAS_END_NAMESPACE
 #    define QAS_JSON(T)    QAS_JSON(T)
 #    define QAS_JSON_NS(T) QAS_JSON_NS(T)
 #else
-#    define QAS_JSON(T)    QAS_JSON_IMPL(T)
-#    define QAS_JSON_NS(T) QAS_JSON_NS_IMPL(T)
+#    define QAS_JSON(T)    QAS_JSON_IMPL(T) QAS_JSON_READER_IMPL(T) QAS_JSON_WRITER_IMPL(T) QAS_JSON_CBOR_IMPL(T)
+#    define QAS_JSON_NS(T)                                                                                             \
+        QAS_JSON_NS_IMPL(T) QAS_JSON_NS_READER_IMPL(T) QAS_JSON_NS_WRITER_IMPL(T) QAS_JSON_NS_CBOR_IMPL(T)
 #endif
 
 
@@ -1043,6 +1524,200 @@ public:
         return valid;
     }
     
+    // Compile a pattern up front, the result can be shared by threads
+    static inline QRegularExpression compilePattern(const QString& pattern) {
+        QRegularExpression regex(pattern);
+        regex.optimize();
+        return regex;
+    }
+    
+    static inline bool validatePattern(const QJsonValue& input, const QRegularExpression& regex, QString* errorMsg = nullptr) {
+        if (!input.isString()) {
+            if (errorMsg) *errorMsg = "PATTERN constraint requires string input";
+            return false;
+        }
+        
+        if (!regex.isValid()) {
+            if (errorMsg) *errorMsg = QString("Invalid regular expression pattern: %1").arg(regex.pattern());
+            return false;
+        }
+        
+        bool valid = regex.match(input.toString()).hasMatch();
+        
+        if (!valid && errorMsg) {
+            *errorMsg = QString("String does not match pattern: %1").arg(regex.pattern());
+        }
+        
+        return valid;
+    }
+    
+    // Native checks used by generated code, arithmetic types and QString are checked directly,
+    // other types are converted to json values first
+    template <class T, class B>
+    static inline bool validateMinimum(const T& input, B bound) {
+        Order order = compareNumber(input, bound, IsNumber<T>());
+        return order == Equal || order == Greater;
+    }
+    
+    template <class T, class B>
+    static inline bool validateMaximum(const T& input, B bound) {
+        Order order = compareNumber(input, bound, IsNumber<T>());
+        return order == Equal || order == Less;
+    }
+    
+    template <class T, class B>
+    static inline bool validateExclusiveMinimum(const T& input, B bound) {
+        return compareNumber(input, bound, IsNumber<T>()) == Greater;
+    }
+    
+    template <class T, class B>
+    static inline bool validateExclusiveMaximum(const T& input, B bound) {
+        return compareNumber(input, bound, IsNumber<T>()) == Less;
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, QLatin1String constant) {
+        QString str;
+        return stringValue(input, &str) && str == constant;
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, const QString& constant) {
+        QString str;
+        return stringValue(input, &str) && str == constant;
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, qint64 constant) {
+        return equalNumber(input, constant, IsNumber<T>());
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, double constant) {
+        return equalNumber(input, constant, IsNumber<T>());
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, bool constant) {
+        return equalBool(input, constant, std::is_same<T, bool>());
+    }
+    
+    template <class T>
+    static inline bool validateConst(const T& input, std::nullptr_t) {
+        return JsonStream::fromValue(input).data().isNull();
+    }
+    
+    template <class T>
+    static inline bool validateEnum(const T& input, const QSet<QString>& values) {
+        QString str;
+        return stringValue(input, &str) && values.contains(str);
+    }
+    
+    template <class T>
+    static inline bool validateEnum(const T& input, const QJsonArray& values) {
+        return validateEnum(JsonStream::fromValue(input).data(), QJsonValue(values));
+    }
+    
+    template <class T>
+    static inline bool validateMinLength(const T& input, int minLength) {
+        QString str;
+        return stringValue(input, &str) && str.size() >= minLength;
+    }
+    
+    template <class T>
+    static inline bool validateMaxLength(const T& input, int maxLength) {
+        QString str;
+        return stringValue(input, &str) && str.size() <= maxLength;
+    }
+    
+    template <class T>
+    static inline bool validatePattern(const T& input, const QRegularExpression& regex) {
+        QString str;
+        return stringValue(input, &str) && regex.match(str).hasMatch();
+    }
+    
+private:
+    enum Order {
+        Less,
+        Equal,
+        Greater,
+        Unordered,
+    };
+    
+    template <class T>
+    using IsNumber = std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>;
+    
+    template <class A, class B>
+    static inline Order compareArithmetic(A a, B b, std::true_type) {
+        // Both integral, compare without wrapping between signed and unsigned
+        bool aNeg = std::is_signed<A>::value && qint64(a) < 0;
+        bool bNeg = std::is_signed<B>::value && qint64(b) < 0;
+        if (aNeg != bNeg) {
+            return aNeg ? Less : Greater;
+        }
+        if (aNeg) {
+            return qint64(a) < qint64(b) ? Less : (qint64(a) > qint64(b) ? Greater : Equal);
+        }
+        return quint64(a) < quint64(b) ? Less : (quint64(a) > quint64(b) ? Greater : Equal);
+    }
+    
+    template <class A, class B>
+    static inline Order compareArithmetic(A a, B b, std::false_type) {
+        double x = double(a);
+        double y = double(b);
+        return x < y ? Less : (x > y ? Greater : (x == y ? Equal : Unordered));
+    }
+    
+    template <class T, class B>
+    static inline Order compareNumber(const T& input, B bound, std::true_type) {
+        return compareArithmetic(input, bound,
+                                 std::integral_constant<bool, std::is_integral<T>::value && std::is_integral<B>::value>());
+    }
+    
+    template <class T, class B>
+    static inline Order compareNumber(const T& input, B bound, std::false_type) {
+        QJsonValue value = JsonStream::fromValue(input).data();
+        if (!isNumeric(value)) {
+            return Unordered;
+        }
+        return compareArithmetic(toDouble(value), bound, std::false_type());
+    }
+    
+    template <class T, class B>
+    static inline bool equalNumber(const T& input, B constant, std::true_type) {
+        return compareNumber(input, constant, std::true_type()) == Equal;
+    }
+    
+    template <class T, class B>
+    static inline bool equalNumber(const T& input, B constant, std::false_type) {
+        return JsonStream::fromValue(input).data() == QJsonValue(double(constant));
+    }
+    
+    template <class T>
+    static inline bool equalBool(const T& input, bool constant, std::true_type) {
+        return input == constant;
+    }
+    
+    template <class T>
+    static inline bool equalBool(const T& input, bool constant, std::false_type) {
+        return JsonStream::fromValue(input).data() == QJsonValue(constant);
+    }
+    
+    static inline bool stringValue(const QString& input, QString* out) {
+        *out = input;
+        return true;
+    }
+    
+    template <class T>
+    static inline bool stringValue(const T& input, QString* out) {
+        QJsonValue value = JsonStream::fromValue(input).data();
+        if (!value.isString()) {
+            return false;
+        }
+        *out = value.toString();
+        return true;
+    }
+    
 private:
     // Helper functions for type checking and conversion
     static inline bool isNumeric(const QJsonValue& value) {
@@ -0,0 +1,909 @@
+/*
+
+   Copyright 2022-2023 Sine Striker
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+*/
+
+#ifndef QJSONWRITER_H
+#define QJSONWRITER_H
+
+#include "qjsonstream.h"
+
+#include <QIODevice>
+#include <QLocale>
+#include <QVarLengthArray>
+
+#include <cmath>
+
+QAS_BEGIN_NAMESPACE
+
+/**
+ * JsonWriter emits UTF-8 json text in a single pass, the generated serializers use it to
+ * write class members directly without building a QJsonObject first.
+ *
+ * The indented format is the same as QJsonDocument::Indented, but keys keep the
+ * declaration order instead of being sorted.
+ *
+ */
+
+class JsonWriter {
+public:
+    enum Format {
+        Indented,
+        Compact,
+    };
+
+    enum {
+        BufferSize = 16 * 1024,
+        ParallelThreshold = 32,
+    };
+
+    explicit JsonWriter(QByteArray *out, Format format = Indented);
+    explicit JsonWriter(QIODevice *device, Format format = Indented);
+    ~JsonWriter();
+
+    inline Format format() const {
+        return q_format;
+    }
+
+    /* Write the remaining buffer to device, returns false if the device fails */
+    bool flush();
+    bool hasError() const;
+
+    /* Write the elements of lists longer than threshold on the pool, nullptr writes on the calling thread */
+    inline QThreadPool *threadPool() const {
+        return q_pool;
+    }
+
+    inline int parallelThreshold() const {
+        return q_parallelThreshold;
+    }
+
+    inline void setThreadPool(QThreadPool *pool, int threshold = ParallelThreshold) {
+        q_pool = pool;
+        q_parallelThreshold = qMax(0, threshold);
+    }
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /* Let the next object write its members into the current object */
+    void mergeObject();
+
+    void writeKey(Utf8View key);
+    void writeKey(QLatin1String key);
+    void writeKey(const QString &key);
+
+    void writeString(Utf8View s);
+    void writeString(QLatin1String s);
+    void writeString(const QString &s);
+    void writeDouble(double d);
+    void writeInteger(qint64 l);
+    void writeUnsigned(quint64 ul);
+    void writeBool(bool b);
+    void writeNull();
+    void writeValue(const QJsonValue &val);
+    void writeRaw(const char *data, qint64 size); // Text of a complete value, without whitespace if compact
+
+    /* Writer of elements of the current array into out with the same options, its text is added with
+       writeElements(), the text is the same as if the elements were written here, error is the hasError()
+       of the element writer and fails this writer instead */
+    JsonWriter elementWriter(QByteArray *out) const;
+    void writeElements(const char *data, qint64 size, bool error = false);
+
+public:
+    JsonWriter &operator<<(qint8 sc);
+    JsonWriter &operator<<(quint8 c);
+    JsonWriter &operator<<(qint16 s);
+    JsonWriter &operator<<(quint16 us);
+    JsonWriter &operator<<(qint32 i);
+    JsonWriter &operator<<(quint32 u);
+    JsonWriter &operator<<(qint64 l);
+    JsonWriter &operator<<(quint64 ul);
+    JsonWriter &operator<<(bool b);
+    JsonWriter &operator<<(float f);
+    JsonWriter &operator<<(double d);
+    JsonWriter &operator<<(const QString &s);
+    JsonWriter &operator<<(const QJsonValue &val);
+    JsonWriter &operator<<(const QJsonArray &arr);
+    JsonWriter &operator<<(const QJsonObject &obj);
+
+private:
+    QByteArray *q_out;
+    QIODevice *q_device;
+    QByteArray q_buf;
+    Format q_format;
+    bool q_error;
+    QThreadPool *q_pool;
+    int q_parallelThreshold;
+
+    enum FrameType : char {
+        ObjectFrame,
+        MergedFrame,
+        ArrayFrame,
+    };
+
+    QVarLengthArray<char, 32> q_frames;
+    int q_level;
+    bool q_first;
+    bool q_afterKey;
+    bool q_merge;
+
+    bool prefix();
+    void newLine(int level);
+    void writeEscaped(const char *str, int len); // UTF-8
+    void writeEscaped(QLatin1String str);
+    void writeEscaped(const QChar *str, int len);
+    void appendNumber(quint64 ul, bool negative);
+    void appendBlock(const char *data, qint64 size);
+    void appendCompact(const char *data, qint64 size);
+    void checkFlush();
+};
+
+// ----------------------------------
+// Implementations
+// ----------------------------------
+
+inline JsonWriter::JsonWriter(QByteArray *out, Format format)
+    : q_out(out), q_device(nullptr), q_format(format), q_error(false), q_pool(nullptr),
+      q_parallelThreshold(ParallelThreshold), q_level(0), q_first(true), q_afterKey(false), q_merge(false) {
+}
+
+inline JsonWriter::JsonWriter(QIODevice *device, Format format)
+    : q_out(&q_buf), q_device(device), q_format(format), q_error(false), q_pool(nullptr),
+      q_parallelThreshold(ParallelThreshold), q_level(0), q_first(true), q_afterKey(false), q_merge(false) {
+    q_buf.reserve(BufferSize);
+}
+
+inline JsonWriter::~JsonWriter() {
+    flush();
+}
+
+inline bool JsonWriter::flush() {
+    if (!q_device || q_buf.isEmpty()) {
+        return !q_error;
+    }
+    if (q_device->write(q_buf) != q_buf.size()) {
+        q_error = true;
+    }
+    q_buf.resize(0);
+    return !q_error;
+}
+
+inline bool JsonWriter::hasError() const {
+    return q_error;
+}
+
+inline void JsonWriter::beginObject() {
+    if (q_merge) {
+        q_merge = false;
+        q_frames.append(MergedFrame);
+        return;
+    }
+    prefix();
+    q_out->append('{');
+    q_frames.append(ObjectFrame);
+    q_level++;
+    q_first = true;
+}
+
+inline void JsonWriter::endObject() {
+    if (q_frames.isEmpty()) {
+        return;
+    }
+    char frame = q_frames.last();
+    q_frames.removeLast();
+    if (frame == MergedFrame) {
+        return;
+    }
+    q_level--;
+    newLine(q_level);
+    q_out->append(frame == ArrayFrame ? ']' : '}');
+    q_first = false;
+    if (q_level == 0 && q_format == Indented) {
+        q_out->append('\n');
+    }
+    checkFlush();
+}
+
+inline void JsonWriter::beginArray() {
+    q_merge = false;
+    prefix();
+    q_out->append('[');
+    q_frames.append(ArrayFrame);
+    q_level++;
+    q_first = true;
+}
+
+inline void JsonWriter::endArray() {
+    endObject();
+}
+
+inline void JsonWriter::mergeObject() {
+    q_merge = q_level > 0;
+}
+
+inline void JsonWriter::writeKey(Utf8View key) {
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(key.data(), key.size());
+    q_out->append(q_format == Compact ? "\":" : "\": ");
+    q_afterKey = true;
+}
+
+inline void JsonWriter::writeKey(QLatin1String key) {
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(key);
+    q_out->append(q_format == Compact ? "\":" : "\": ");
+    q_afterKey = true;
+}
+
+inline void JsonWriter::writeKey(const QString &key) {
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(key.constData(), key.size());
+    q_out->append(q_format == Compact ? "\":" : "\": ");
+    q_afterKey = true;
+}
+
+inline void JsonWriter::writeString(Utf8View s) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(s.data(), s.size());
+    q_out->append('"');
+    checkFlush();
+}
+
+inline void JsonWriter::writeString(QLatin1String s) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(s);
+    q_out->append('"');
+    checkFlush();
+}
+
+inline void JsonWriter::writeString(const QString &s) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    q_out->append('"');
+    writeEscaped(s.constData(), s.size());
+    q_out->append('"');
+    checkFlush();
+}
+
+inline void JsonWriter::writeDouble(double d) {
+    // Same as QJsonDocument, integral values are written without exponent, -0 keeps its sign
+    const double abs = std::abs(d);
+    if (abs < 9007199254740992.0 && d == double(qint64(d)) && !(d == 0 && std::signbit(d))) {
+        writeInteger(qint64(d));
+        return;
+    }
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    if (!std::isfinite(d)) {
+        q_out->append("null");
+    } else {
+        // Larger integral values up to 2^64 are still written as decimals, like 100000000000000000000
+        const bool fixed = abs < 18446744073709551616.0 && d == std::floor(d);
+#ifdef QAS_HAS_TO_CHARS
+        char buf[32];
+        q_out->append(buf, JsonStreamPrivate::formatDouble(d, fixed, buf));
+#else
+        q_out->append(QByteArray::number(d, fixed ? 'f' : 'g', QLocale::FloatingPointShortest));
+#endif
+    }
+    checkFlush();
+}
+
+inline void JsonWriter::writeInteger(qint64 l) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    appendNumber(l < 0 ? 0 - quint64(l) : quint64(l), l < 0);
+    checkFlush();
+}
+
+inline void JsonWriter::writeUnsigned(quint64 ul) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    appendNumber(ul, false);
+    checkFlush();
+}
+
+inline void JsonWriter::writeBool(bool b) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    q_out->append(b ? "true" : "false");
+    checkFlush();
+}
+
+inline void JsonWriter::writeNull() {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    q_out->append("null");
+    checkFlush();
+}
+
+inline void JsonWriter::writeRaw(const char *data, qint64 size) {
+    q_merge = false;
+    if (!prefix()) {
+        return;
+    }
+    if (q_format == Compact) {
+        appendCompact(data, size);
+        return;
+    }
+    appendBlock(data, size);
+}
+
+inline JsonWriter JsonWriter::elementWriter(QByteArray *out) const {
+    // Each fragment starts without a comma, writeElements() adds it
+    JsonWriter writer(out, q_format);
+    writer.q_pool = q_pool;
+    writer.q_parallelThreshold = q_parallelThreshold;
+    writer.q_level = q_level;
+    return writer;
+}
+
+inline void JsonWriter::writeElements(const char *data, qint64 size, bool error) {
+    if (error) {
+        q_error = true;
+    }
+    if (q_error || size == 0) {
+        return;
+    }
+    if (!q_first) {
+        q_out->append(',');
+    }
+    q_first = false;
+    appendBlock(data, size);
+}
+
+inline void JsonWriter::writeValue(const QJsonValue &val) {
+    switch (val.type()) {
+        case QJsonValue::Object: {
+            const QJsonObject &obj = val.toObject();
+            beginObject();
+            for (auto it = obj.begin(); it != obj.end(); ++it) {
+                writeKey(it.key());
+                writeValue(it.value());
+            }
+            endObject();
+            break;
+        }
+        case QJsonValue::Array: {
+            const QJsonArray &arr = val.toArray();
+            beginArray();
+            for (const auto &item : arr) {
+                writeValue(item);
+            }
+            endArray();
+            break;
+        }
+        case QJsonValue::String:
+            writeString(val.toString());
+            break;
+        case QJsonValue::Double:
+            writeDouble(val.toDouble());
+            break;
+        case QJsonValue::Bool:
+            writeBool(val.toBool());
+            break;
+        default:
+            writeNull();
+            break;
+    }
+}
+
+inline bool JsonWriter::prefix() {
+    // Leave room for the separator, the indentation and a scalar value
+    if (q_out->size() > JsonStreamPrivate::MaxSize - 64 - q_level * 4) {
+        if (!q_error) {
+            qAsDbg() << "QAS::JsonWriter: output exceeds " << JsonStreamPrivate::MaxSize << " bytes";
+        }
+        q_error = true;
+        return false;
+    }
+    if (q_afterKey) {
+        q_afterKey = false;
+        return true;
+    }
+    if (q_level == 0) {
+        return true;
+    }
+    if (!q_first) {
+        q_out->append(',');
+    }
+    q_first = false;
+    newLine(q_level);
+    return true;
+}
+
+inline void JsonWriter::newLine(int level) {
+    if (q_format == Compact) {
+        return;
+    }
+    static const char spaces[] = "                                ";
+    q_out->append('\n');
+    for (int n = level * 4; n > 0; n -= 32) {
+        q_out->append(spaces, qMin(n, 32));
+    }
+}
+
+inline void JsonWriter::writeEscaped(const char *str, int len) {
+    const char *end = str + len;
+    const char *start = str;
+    for (; str < end; ++str) {
+        uchar c = uchar(*str);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        q_out->append(start, int(str - start));
+        start = str + 1;
+        switch (c) {
+            case '"':
+                q_out->append("\\\"");
+                break;
+            case '\\':
+                q_out->append("\\\\");
+                break;
+            case '\b':
+                q_out->append("\\b");
+                break;
+            case '\f':
+                q_out->append("\\f");
+                break;
+            case '\n':
+                q_out->append("\\n");
+                break;
+            case '\r':
+                q_out->append("\\r");
+                break;
+            case '\t':
+                q_out->append("\\t");
+                break;
+            default: {
+                static const char hex[] = "0123456789abcdef";
+                char buf[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                q_out->append(buf, 6);
+                break;
+            }
+        }
+    }
+    q_out->append(start, int(end - start));
+}
+
+inline void JsonWriter::writeEscaped(QLatin1String str) {
+    // Latin-1 is the same as UTF-8 below 0x80, the rest takes two bytes
+    const char *p = str.data();
+    const char *end = p + str.size();
+    const char *start = p;
+    for (; p < end; ++p) {
+        const uchar c = uchar(*p);
+        if (c < 0x80) {
+            continue;
+        }
+        writeEscaped(start, int(p - start));
+        char buf[2] = {char(0xC0 | (c >> 6)), char(0x80 | (c & 0x3F))};
+        q_out->append(buf, 2);
+        start = p + 1;
+    }
+    writeEscaped(start, int(end - start));
+}
+
+inline void JsonWriter::writeEscaped(const QChar *str, int len) {
+    const QChar *end = str + len;
+    char buf[4];
+    for (; str < end; ++str) {
+        uint u = str->unicode();
+
+        // ASCII
+        if (u < 0x80) {
+            char c = char(u);
+            if (u >= 0x20 && c != '"' && c != '\\') {
+                q_out->append(c);
+            } else {
+                writeEscaped(&c, 1);
+            }
+            continue;
+        }
+
+        // Encode as UTF-8
+        if (u < 0x800) {
+            buf[0] = char(0xC0 | (u >> 6));
+            buf[1] = char(0x80 | (u & 0x3F));
+            q_out->append(buf, 2);
+            continue;
+        }
+        if (str->isHighSurrogate() && str + 1 < end && (str + 1)->isLowSurrogate()) {
+            u = QChar::surrogateToUcs4(*str, *(str + 1));
+            ++str;
+            buf[0] = char(0xF0 | (u >> 18));
+            buf[1] = char(0x80 | ((u >> 12) & 0x3F));
+            buf[2] = char(0x80 | ((u >> 6) & 0x3F));
+            buf[3] = char(0x80 | (u & 0x3F));
+            q_out->append(buf, 4);
+            continue;
+        }
+        if (str->isSurrogate()) {
+            u = 0xFFFD;
+        }
+        buf[0] = char(0xE0 | (u >> 12));
+        buf[1] = char(0x80 | ((u >> 6) & 0x3F));
+        buf[2] = char(0x80 | (u & 0x3F));
+        q_out->append(buf, 3);
+    }
+}
+
+inline void JsonWriter::appendNumber(quint64 ul, bool negative) {
+    static const char digits[] = "00010203040506070809"
+                                 "10111213141516171819"
+                                 "20212223242526272829"
+                                 "30313233343536373839"
+                                 "40414243444546474849"
+                                 "50515253545556575859"
+                                 "60616263646566676869"
+                                 "70717273747576777879"
+                                 "80818283848586878889"
+                                 "90919293949596979899";
+
+    // Two digits per division, in 32 bits once the value fits
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    while (ul > 0xFFFFFFFFu) {
+        const uint i = uint(ul % 100) * 2;
+        ul /= 100;
+        p -= 2;
+        memcpy(p, digits + i, 2);
+    }
+    uint u = uint(ul);
+    while (u >= 100) {
+        const uint i = (u % 100) * 2;
+        u /= 100;
+        p -= 2;
+        memcpy(p, digits + i, 2);
+    }
+    if (u >= 10) {
+        p -= 2;
+        memcpy(p, digits + u * 2, 2);
+    } else {
+        *--p = char('0' + u);
+    }
+    if (negative) {
+        *--p = '-';
+    }
+    q_out->append(p, int(buf + sizeof(buf) - p));
+}
+
+inline void JsonWriter::appendBlock(const char *data, qint64 size) {
+    // A block larger than the buffer goes to the device directly, it may not fit into a QByteArray
+    if (q_device && size >= BufferSize) {
+        flush();
+        if (!q_error && q_device->write(data, size) != size) {
+            q_error = true;
+        }
+        return;
+    }
+    if (q_out->size() + size > JsonStreamPrivate::MaxSize) {
+        qAsDbg() << "QAS::JsonWriter: output exceeds " << JsonStreamPrivate::MaxSize << " bytes";
+        q_error = true;
+        return;
+    }
+    q_out->append(data, int(size));
+    checkFlush();
+}
+
+inline void JsonWriter::appendCompact(const char *data, qint64 size) {
+    // Drop the whitespace outside strings, raw text may come from an indented document
+    const char *end = data + size;
+    const char *start = data;
+    bool inString = false;
+    for (const char *p = data; p < end; ++p) {
+        char c = *p;
+        if (inString) {
+            if (c == '\\') {
+                ++p;
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            if (p > start) {
+                appendBlock(start, p - start);
+            }
+            start = p + 1;
+        }
+    }
+    if (end > start) {
+        appendBlock(start, end - start);
+    }
+}
+
+inline void JsonWriter::checkFlush() {
+    if (q_device && q_buf.size() >= BufferSize) {
+        flush();
+    }
+}
+
+inline JsonWriter &JsonWriter::operator<<(qint8 sc) {
+    writeInteger(sc);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(quint8 c) {
+    writeInteger(c);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(qint16 s) {
+    writeInteger(s);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(quint16 us) {
+    writeInteger(us);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(qint32 i) {
+    writeInteger(i);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(quint32 u) {
+    writeInteger(u);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(qint64 l) {
+    writeInteger(l);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(quint64 ul) {
+    writeUnsigned(ul);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(bool b) {
+    writeBool(b);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(float f) {
+    writeDouble(f);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(double d) {
+    writeDouble(d);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(const QString &s) {
+    writeString(s);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(const QJsonValue &val) {
+    writeValue(val);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(const QJsonArray &arr) {
+    writeValue(arr);
+    return *this;
+}
+
+inline JsonWriter &JsonWriter::operator<<(const QJsonObject &obj) {
+    writeValue(obj);
+    return *this;
+}
+
+// ----------------------------------
+// User Implementation Part
+// ----------------------------------
+
+/* Fallback for classes which only have JsonStream implementations */
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const T &var) {
+    writer.writeValue(JsonStream::fromValue(var).data());
+    return writer;
+}
+
+// ----------------------------------
+// Supported Containers
+// ----------------------------------
+
+namespace JsonWriterContainers {
+
+    // Chunks of elements are written into separate fragments on the pool and appended in order
+    template <class LIST>
+    void writeParallel(JsonWriter &writer, const LIST &list) {
+        std::vector<const typename LIST::value_type *> items;
+        items.reserve(list.size());
+        for (const auto &item : qAsConst(list)) {
+            items.push_back(&item);
+        }
+
+        const int count = int(items.size());
+        const int threads = qMax(1, writer.threadPool()->maxThreadCount());
+        const int chunk = qMax(1, count / (4 * threads));
+        std::vector<QByteArray> fragments((count + chunk - 1) / chunk);
+        std::vector<char> errors(fragments.size(), false);
+
+        // The pool is busy with this list, the lists of the elements are written on their thread
+        auto encode = [&](int begin, int end) {
+            JsonWriter elementWriter = writer.elementWriter(&fragments[begin / chunk]);
+            elementWriter.setThreadPool(nullptr);
+            for (int i = begin; i < end && !elementWriter.hasError(); ++i) {
+                elementWriter << *items[i];
+            }
+            errors[begin / chunk] = elementWriter.hasError();
+        };
+        JsonStreamPrivate::runParallel(writer.threadPool(), count, chunk, encode);
+
+        for (size_t i = 0; i < fragments.size() && !writer.hasError(); ++i) {
+            writer.writeElements(fragments[i].constData(), fragments[i].size(), errors[i]);
+        }
+    }
+
+    // List Implementations
+    template <class LIST>
+    JsonWriter &readList(JsonWriter &writer, const LIST &list) {
+        writer.beginArray();
+        if (JsonStreamPrivate::IsParallel<typename LIST::value_type>::value && writer.threadPool() &&
+            size_t(list.size()) > size_t(writer.parallelThreshold())) {
+            writeParallel(writer, list);
+        } else {
+            for (const auto &item : qAsConst(list)) {
+                writer << item;
+            }
+        }
+        writer.endArray();
+        return writer;
+    }
+
+    // Map Implementations
+    template <class MAP, class OP>
+    JsonWriter &readMap(JsonWriter &writer, const MAP &map, OP op) {
+        writer.beginObject();
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            writer.writeKey(op.key(it));
+            writer << op.value(it);
+        }
+        writer.endObject();
+        return writer;
+    }
+
+}
+
+// std::vector
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const std::vector<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+// std::list
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const std::list<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+// std::set
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const std::set<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+// QList
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const QList<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+#endif
+
+// QSet
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const QSet<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+// QVector
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const QVector<T> &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+// QStringList
+inline JsonWriter &operator<<(JsonWriter &writer, const QStringList &list) {
+    return QAS::JsonWriterContainers::readList(writer, list);
+}
+
+// std::map
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const std::map<QString, T> &map) {
+    return QAS::JsonWriterContainers::readMap(writer, map, STLMapOps());
+}
+
+// std::unordered_map
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const std::unordered_map<QString, T> &map) {
+    return QAS::JsonWriterContainers::readMap(writer, map, STLMapOps());
+}
+
+// QMap
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const QMap<QString, T> &map) {
+    return QAS::JsonWriterContainers::readMap(writer, map, QtMapOps());
+}
+
+// QHash
+template <class T>
+JsonWriter &operator<<(JsonWriter &writer, const QHash<QString, T> &map) {
+    return QAS::JsonWriterContainers::readMap(writer, map, QtMapOps());
+}
+
+QAS_END_NAMESPACE
+
+// ----------------------------------
+// Simplified Macros or Functions
+// ----------------------------------
+
+// Non-Basic Class -> UTF-8 Json Text
+template <class T>
+QByteArray qAsClassToJsonData(const T &var, QAS::JsonWriter::Format format = QAS::JsonWriter::Indented) {
+    QByteArray data;
+    QAS::JsonWriter writer(&data, format);
+    writer << var;
+    return data;
+}
+
+template <class T>
+bool qAsClassWriteJson(const T &var, QIODevice *device, QAS::JsonWriter::Format format = QAS::JsonWriter::Indented) {
+    QAS::JsonWriter writer(device, format);
+    writer << var;
+    return writer.flush();
+}
+
+#endif // QJSONWRITER_H
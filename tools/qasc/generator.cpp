@@ -2,6 +2,8 @@
 
 #include "nameutil.h"
 
+#include <cmath>
+
 static QByteArray fixClassName(Environment *env, const QByteArray &unqualified) {
     auto qualified = NameUtil::getQualifiedNameList(env);
 
@@ -14,6 +16,24 @@ static QByteArray fixClassName(Environment *env, const QByteArray &unqualified)
     return qualified.join("::");
 }
 
+static QByteArray constraintNumber(double value) {
+    // Integral bounds are compared as integers
+    if (value == std::floor(value) && std::abs(value) < 9.2e18) {
+        return "Q_INT64_C(" + QByteArray::number(qint64(value)) + ")";
+    }
+    return QByteArray::number(value, 'g', 17);
+}
+
+static QByteArray constraintString(const QString &value) {
+    QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        if (uchar(c) >= 0x80) {
+            return "QStringLiteral(\"" + utf8 + "\")";
+        }
+    }
+    return "QLatin1String(\"" + utf8 + "\")";
+}
+
 void Generator::generateCode() {
     QList<Environment *> envsToProcess;
 
@@ -55,9 +75,10 @@ void Generator::generateCode() {
 
     //    fprintf(fp, "\n");
 
-    // Generate implementations
+    // Collect implementations, all classes of the file must be known before generating
     QSet<QByteArray> classes;
     QSet<QByteArray> enums;
+    QVector<std::function<void()>> jobs;
     for (auto env: qAsConst(envsToProcess)) {
         QByteArray prefix;
         // Get namespace
@@ -108,7 +129,10 @@ void Generator::generateCode() {
                 }
                 enums.insert(enumName);
 
-                generateEnums(prefix.isEmpty() ? QByteArray() : prefix + "::", enumName, it.value());
+                const EnumDef *enumDef = &it.value();
+                jobs.append([this, prefix, enumName, enumDef]() {
+                    generateEnums(prefix.isEmpty() ? QByteArray() : prefix + "::", enumName, *enumDef);
+                });
                 continue;
             }
 
@@ -137,6 +161,7 @@ void Generator::generateCode() {
 
             // Class
             QByteArrayList superNameList;
+            QVector<bool> publicSuperList;
 
             for (const auto &super: qAsConst(classDef.superclassList)) {
                 // Collect super class
@@ -178,11 +203,102 @@ void Generator::generateCode() {
                         break;
                 }
                 superNameList.append(superName);
+                publicSuperList.append(info.access == FunctionDef::Public);
             }
 
-            generateClass(prefix.isEmpty() ? QByteArray() : prefix + "::", className, superNameList, classDef);
+            const ClassDef *classDefPtr = &classDef;
+            classInfos.insert(className, {classDefPtr, superNameList, publicSuperList});
+            jobs.append([this, prefix, className, superNameList, classDefPtr]() {
+                generateClass(prefix.isEmpty() ? QByteArray() : prefix + "::", className, superNameList,
+                              *classDefPtr);
+            });
+        }
+    }
+
+    // The header only needs qjsonstream.h, the implementations use every reader and writer
+    if (!jobs.isEmpty()) {
+        fprintf(fp, "#include \"qjsonreader.h\"\n"
+                    "#include \"qjsonwriter.h\"\n"
+                    "#include \"qcborreader.h\"\n"
+                    "#include \"qcborwriter.h\"\n"
+                    "\n");
+    }
+
+    // Generate implementations
+    for (const auto &job: qAsConst(jobs)) {
+        job();
+    }
+}
+
+Generator::MemberTable Generator::memberTable(const QByteArrayList &supers, const ClassDef &def,
+                                              bool flatten) const {
+    MemberTable table;
+    for (const auto &super: supers) {
+        if (!flatten || !flattenBase(super, &table)) {
+            table.supers.append(super);
+        }
+    }
+
+    for (const auto &item: def.memberVars) {
+        if (item.access == FunctionDef::Public) {
+            if (item.exclude)
+                continue;
+        } else {
+            if (!item.include)
+                continue;
+        }
+        table.members.append(&item);
+        table.keys.append(item.attr.isEmpty() ? item.name : item.attr);
+        table.paths.append(item.name);
+    }
+
+    // A key read by both a base and the class, keep the bases separate
+    if (flatten) {
+        QSet<QByteArray> keySet;
+        for (const auto &key: qAsConst(table.keys)) {
+            keySet.insert(key);
+        }
+        if (keySet.size() != table.keys.size()) {
+            return memberTable(supers, def, false);
+        }
+    }
+    return table;
+}
+
+bool Generator::flattenBase(const QByteArray &qualified, MemberTable *table) const {
+    auto it = classInfos.find(qualified);
+    if (it == classInfos.end()) {
+        return false;
+    }
+
+    // Members of the bases of a non-public base are not accessible from the derived class
+    MemberTable tmp;
+    for (int i = 0; i < it->supers.size(); ++i) {
+        if (!it->publicSupers.at(i) || !flattenBase(it->supers.at(i), &tmp)) {
+            return false;
+        }
+    }
+
+    for (const auto &item: it->def->memberVars) {
+        if (item.access == FunctionDef::Public) {
+            if (item.exclude)
+                continue;
+        } else {
+            // Private members of a base are not accessible from the derived class
+            if (!item.include)
+                continue;
+            if (item.access == FunctionDef::Private)
+                return false;
         }
+        tmp.members.append(&item);
+        tmp.keys.append(item.attr.isEmpty() ? item.name : item.attr);
+        tmp.paths.append(qualified + "::" + item.name);
     }
+
+    table->members += tmp.members;
+    table->keys += tmp.keys;
+    table->paths += tmp.paths;
+    return true;
 }
 
 // void Generator::generateUsing(const QByteArray &qualified) {
@@ -204,40 +320,45 @@ void Generator::generateEnums(const QByteArray &ns, const QByteArray &qualified,
         fprintf(fp, "%s\n%s\n%s\n\n", line.data(), title.data(), line.data());
     }
 
+    // Collect values participating in conversion
+    QVector<const JsonAttributes *> values;
+    QByteArrayList keys;
+    for (const auto &item: def.values) {
+        if (item.exclude) {
+            continue;
+        }
+        values.append(&item);
+        keys.append(item.attr.isEmpty() ? item.itemName : item.attr);
+    }
+
     // Generate deserializer
     // Declaration head
     fmt = "QAS::JsonStream &%soperator>>(QAS::JsonStream &_stream, %s &_var) {\n";
     fprintf(fp, fmt, ns_str, type_str);
 
     // Convert to string
-    fprintf(fp, "    QString _str;\n"
-                "    if (!QAS::JsonStreamUtils::parseAsString(_stream, typeid(_var).name(), &_str).good()) {\n"
-                "        return _stream;\n"
-                "    }\n\n");
+    fmt = "    QString _str;\n"
+          "    if (!QAS::JsonStreamUtils::parseAsString(_stream, \"%s\", &_str).good()) {\n"
+          "        return _stream;\n"
+          "    }\n\n";
+    fprintf(fp, fmt, type_str);
 
     // Define res
     fmt = "    %s _tmp{};\n";
     fprintf(fp, fmt, type_str);
 
-    // Start branches
-    fprintf(fp, "    ");
-    for (const auto &item: def.values) {
-        if (item.exclude) {
-            continue;
-        }
-        QByteArray attr = item.attr.isEmpty() ? item.itemName : item.attr;
-        fmt = "if (_str == \"%s\") {\n"
-              "        _tmp = %s::%s;\n"
-              "    } else ";
-        fprintf(fp, fmt, attr.data(), type_str, item.itemName.data());
-    }
-
-    fprintf(fp, " {\n");
+    // Start branches, dispatch by length and then by string
+    generateKeySwitch(
+        "_str", false, keys, 4,
+        [&](int index, const char *pad_str) {
+            fprintf(fp, "%s_tmp = %s::%s;\n", pad_str, type_str, values.at(index)->itemName.data());
+        },
+        [&](const char *pad_str) {
+            fprintf(fp, "%s_stream.setStatus(QAS::JsonStream::UnlistedValue);\n", pad_str);
+        });
 
     // Last and end
-    fprintf(fp, "        _stream.setStatus(QAS::JsonStream::UnlistedValue);\n"
-                "    }\n"
-                "    _var = _tmp;\n"
+    fprintf(fp, "    _var = _tmp;\n"
                 "\n"
                 "    return _stream;\n"
                 "}\n");
@@ -249,34 +370,48 @@ void Generator::generateEnums(const QByteArray &ns, const QByteArray &qualified,
     fmt = "QAS::JsonStream &%soperator<<(QAS::JsonStream &_stream, const %s &_var) {\n";
     fprintf(fp, fmt, ns_str, type_str);
 
+    // Static string table, the last one is for unlisted values
+    fprintf(fp, "    static const QString _strs[] = {\n");
+    for (const auto &key: keys) {
+        fprintf(fp, "        QStringLiteral(\"%s\"),\n", key.data());
+    }
+    fprintf(fp, "        QString(),\n"
+                "    };\n"
+                "\n");
+
     // Define res
-    fprintf(fp, "    _stream.resetStatus();\n"
-                "\n"
-                "    QString _tmp;\n"
-                "    switch (_var) {\n");
+    fmt = "    _stream.resetStatus();\n"
+          "\n"
+          "    int _index = %d;\n"
+          "    switch (_var) {\n";
+    fprintf(fp, fmt, keys.size());
 
     // Start switch
-    for (const auto &item: def.values) {
-        if (item.exclude) {
-            continue;
-        }
-        QByteArray attr = item.attr.isEmpty() ? item.itemName : item.attr;
+    for (int i = 0; i < values.size(); ++i) {
         fmt = "        case %s::%s:\n"
-              "            _tmp = \"%s\";\n"
+              "            _index = %d;\n"
               "            break;\n";
-        fprintf(fp, fmt, type_str, item.itemName.data(), attr.data());
+        fprintf(fp, fmt, type_str, values.at(i)->itemName.data(), i);
     }
 
     // Last and end
     fprintf(fp, "        default:\n"
                 "            break;\n"
                 "    }\n"
-                "    _stream << _tmp;\n"
+                "    _stream << _strs[_index];\n"
                 "\n"
                 "    return _stream;\n"
                 "}\n");
 
-    fprintf(fp, "\n\n");
+    fprintf(fp, "\n");
+
+    // Generate writer serializer and reader deserializer for each format
+    for (const char *format : {"Json", "Cbor"}) {
+        generateEnumWriter(format, ns, qualified, keys, values);
+        generateEnumReader(format, ns, qualified, keys, values);
+    }
+
+    fprintf(fp, "\n");
 }
 
 void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
@@ -292,16 +427,21 @@ void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
         fprintf(fp, "%s\n%s\n%s\n\n", line.data(), title.data(), line.data());
     }
 
+    // Collect members participating in conversion, members of the flattened bases are read and
+    // written in the same pass as the class's own
+    const MemberTable flat = memberTable(supers, def, true);
+
     // Generate deserializer
     // Declaration head
     fmt = "QAS::JsonStream &%soperator>>(QAS::JsonStream &_stream, %s &_var) {\n";
     fprintf(fp, fmt, ns_str, type_str);
 
     // Convert to object
-    fprintf(fp, "    QJsonObject _obj;\n"
-                "    if (!QAS::JsonStreamUtils::parseAsObject(_stream, typeid(_var).name(), &_obj).good()) {\n"
-                "        return _stream;\n"
-                "    }\n\n");
+    fmt = "    QJsonObject _obj;\n"
+          "    if (!QAS::JsonStreamUtils::parseAsObject(_stream, \"%s\", &_obj).good()) {\n"
+          "        return _stream;\n"
+          "    }\n\n";
+    fprintf(fp, fmt, type_str);
 
     // Define res
     fmt = "    %s _tmpVar{};\n"
@@ -310,7 +450,7 @@ void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
     fprintf(fp, fmt, type_str);
 
     // Super classes
-    for (const auto &super: supers) {
+    for (const auto &super: flat.supers) {
         const char *name_str = super.data();
         fmt = "    _stream >> *static_cast<%s *>(&_tmpVar);\n"
               "    if (!_stream.good()) {\n"
@@ -319,27 +459,57 @@ void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
         fprintf(fp, fmt, name_str);
     }
 
-    // Start branches
-    for (const auto &item: def.memberVars) {
-        if (item.access == FunctionDef::Public) {
-            if (item.exclude)
-                continue;
-        } else {
-            if (!item.include)
-                continue;
-        }
-        QByteArray attr = item.attr.isEmpty() ? item.name : item.attr;
-        const char *name_str = item.name.data();
-        fmt = "    if (!(_tmpStream = QAS::JsonStreamUtils::parseObjectMember(_obj, \"%s\", typeid(_tmpVar).name(), &_tmpVar.%s)).good()) {\n"
-              "        _stream.setStatus(_tmpStream.status());\n"
-              "        return _stream;\n"
-              "    }\n";
-        fprintf(fp, fmt, attr.data(), name_str);
-        
-        // Generate constraint validation if constraints exist
-        if (!item.constraintGroups.isEmpty()) {
-            generateConstraintValidation(item.name, item.constraintGroups);
-        }
+    // Start branches, iterate the object once and dispatch by key, a failing member is recorded and the lowest
+    // index is reported after the walk, so the error doesn't depend on the sorted keys of QJsonObject
+    if (!flat.members.isEmpty()) {
+        fprintf(fp, "\n"
+                    "    bool _seen[%d] = {};\n"
+                    "    int _failIndex = %d;\n"
+                    "    QAS::JsonStream::Status _failStatus = QAS::JsonStream::Ok;\n"
+                    "    for (auto _it = _obj.constBegin(); _it != _obj.constEnd(); ++_it) {\n"
+                    "        const QString _key = _it.key();\n",
+                flat.members.size(), flat.members.size());
+        generateKeySwitch(
+            "_key", false, flat.keys, 8,
+            [&](int index, const char *pad_str) {
+                const MemberVariableDef &item = *flat.members.at(index);
+                const QByteArray &attr = flat.keys.at(index);
+                const char *name_str = flat.paths.at(index).data();
+                // Members after a failing one can't change the result
+                fprintf(fp, "%s_seen[%d] = true;\n", pad_str, index);
+                if (index > 0) {
+                    fmt = "%sif (_failIndex < %d) {\n"
+                          "%s    continue;\n"
+                          "%s}\n";
+                    fprintf(fp, fmt, pad_str, index, pad_str, pad_str);
+                }
+                fmt = "%sif (!(_tmpStream = QAS::JsonStreamUtils::parseMemberValue(_it.value(), \"%s\", \"%s\", &_tmpVar.%s)).good()) {\n"
+                      "%s    _failIndex = %d;\n"
+                      "%s    _failStatus = _tmpStream.status();\n"
+                      "%s    continue;\n"
+                      "%s}\n";
+                fprintf(fp, fmt, pad_str, attr.data(), type_str, name_str, pad_str, index, pad_str, pad_str, pad_str);
+
+                // Generate constraint validation if constraints exist
+                if (!item.constraintGroups.isEmpty()) {
+                    generateConstraintValidation("_stream", flat.paths.at(index), item.constraintGroups,
+                                                 int(strlen(pad_str)), index);
+                }
+            },
+            nullptr);
+        fprintf(fp, "    }\n");
+
+        // Report the first missing key or failing member in declaration order
+        fprintf(fp, "    for (int _i = 0; _i < _failIndex; ++_i) {\n"
+                    "        if (!_seen[_i]) {\n"
+                    "            _stream.setStatus(QAS::JsonStream::KeyNotFound);\n"
+                    "            return _stream;\n"
+                    "        }\n"
+                    "    }\n"
+                    "    if (_failStatus != QAS::JsonStream::Ok) {\n"
+                    "        _stream.setStatus(_failStatus);\n"
+                    "        return _stream;\n"
+                    "    }\n");
     }
 
     // Last and end
@@ -360,32 +530,28 @@ void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
                 "\n"
                 "    QJsonObject _obj;\n");
 
-    // Super classes
-    for (const auto &super: supers) {
+    // Super classes that are not flattened, the first one becomes the object itself
+    for (int i = 0; i < flat.supers.size(); ++i) {
+        const char *name_str = flat.supers.at(i).data();
+        if (i == 0) {
+            fmt = "    _obj = qAsClassToJson(*static_cast<const %s *>(&_var));\n";
+            fprintf(fp, fmt, name_str);
+            continue;
+        }
         fmt =
                 "    {\n"
-                "        QJsonObject _tmpObj = qAsClassToJson(*static_cast<const %s *>(&_var));\n"
+                "        const QJsonObject _tmpObj = qAsClassToJson(*static_cast<const %s *>(&_var));\n"
                 "        for (auto it = _tmpObj.begin(); it != _tmpObj.end(); ++it) {\n"
                 "            _obj.insert(it.key(), it.value());\n"
                 "        }\n"
                 "    }\n";
-        const char *name_str = super.data();
         fprintf(fp, fmt, name_str);
     }
 
-    // Start switch
-    for (const auto &item: def.memberVars) {
-        if (item.access == FunctionDef::Public) {
-            if (item.exclude)
-                continue;
-        } else {
-            if (!item.include)
-                continue;
-        }
-        QByteArray attr = item.attr.isEmpty() ? item.name : item.attr;
+    // Members of the class and its flattened bases
+    for (int i = 0; i < flat.members.size(); ++i) {
         fmt = "    _obj.insert(\"%s\", QAS::JsonStream::fromValue(_var.%s).data());\n";
-        const char *name_str = item.name.data();
-        fprintf(fp, fmt, attr.data(), name_str);
+        fprintf(fp, fmt, flat.keys.at(i).data(), flat.paths.at(i).data());
     }
 
     // Last and end
@@ -394,30 +560,374 @@ void Generator::generateClass(const QByteArray &ns, const QByteArray &qualified,
                 "    return _stream;\n"
                 "}\n");
 
-    fprintf(fp, "\n\n");
+    fprintf(fp, "\n");
+
+    // Generate writer serializer and reader deserializer for each format
+    for (const char *format : {"Json", "Cbor"}) {
+        generateClassWriter(format, ns, qualified, flat);
+        generateClassReader(format, ns, qualified, flat);
+    }
+
+    fprintf(fp, "\n");
 }
 
-void Generator::generateConstraintValidation(const QByteArray &fieldName, 
-                                            const QVector<ConstraintGroup> &constraintGroups) {
+void Generator::generateEnumWriter(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                                   const QByteArrayList &keys, const QVector<const JsonAttributes *> &values) {
+    const char *fmt;
+    const char *type_str = qualified.data();
+    const char *ns_str = ns.data();
+
+    // Declaration head
+    fmt = "QAS::%sWriter &%soperator<<(QAS::%sWriter &_writer, const %s &_var) {\n";
+    fprintf(fp, fmt, format, ns_str, format, type_str);
+
+    // Static UTF-8 table, the last one is for unlisted values
+    fprintf(fp, "    static const QAS::Utf8View _strs[] = {\n");
+    for (const auto &key: keys) {
+        fprintf(fp, "        QAS::Utf8View(\"%s\"),\n", key.data());
+    }
+    fprintf(fp, "        QAS::Utf8View(),\n"
+                "    };\n"
+                "\n");
+
+    fmt = "    int _index = %d;\n"
+          "    switch (_var) {\n";
+    fprintf(fp, fmt, keys.size());
+
+    // Start switch
+    for (int i = 0; i < values.size(); ++i) {
+        fmt = "        case %s::%s:\n"
+              "            _index = %d;\n"
+              "            break;\n";
+        fprintf(fp, fmt, type_str, values.at(i)->itemName.data(), i);
+    }
+
+    // Last and end
+    fprintf(fp, "        default:\n"
+                "            break;\n"
+                "    }\n"
+                "    _writer.writeString(_strs[_index]);\n"
+                "\n"
+                "    return _writer;\n"
+                "}\n");
+
+    fprintf(fp, "\n");
+}
+
+void Generator::generateEnumReader(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                                   const QByteArrayList &keys, const QVector<const JsonAttributes *> &values) {
+    const char *fmt;
+    const char *type_str = qualified.data();
+    const char *ns_str = ns.data();
+
+    // Declaration head
+    fmt = "QAS::%sReader &%soperator>>(QAS::%sReader &_reader, %s &_var) {\n";
+    fprintf(fp, fmt, format, ns_str, format, type_str);
+
+    // Read string
+    fmt = "    QAS::Utf8View _str;\n"
+          "    if (!QAS::%sReaderUtils::parseAsString(_reader, \"%s\", &_str)) {\n"
+          "        return _reader;\n"
+          "    }\n\n";
+    fprintf(fp, fmt, format, type_str);
+
+    // Define res
+    fmt = "    %s _tmp{};\n";
+    fprintf(fp, fmt, type_str);
+
+    // Start branches, dispatch by length and then by bytes
+    generateKeySwitch(
+        "_str", true, keys, 4,
+        [&](int index, const char *pad_str) {
+            fprintf(fp, "%s_tmp = %s::%s;\n", pad_str, type_str, values.at(index)->itemName.data());
+        },
+        [&](const char *pad_str) {
+            fprintf(fp, "%s_reader.setStatus(QAS::JsonStream::UnlistedValue);\n", pad_str);
+        });
+
+    // Last and end
+    fprintf(fp, "    _var = _tmp;\n"
+                "\n"
+                "    return _reader;\n"
+                "}\n");
+
+    fprintf(fp, "\n");
+}
+
+void Generator::generateClassWriter(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                                    const MemberTable &table) {
+    const char *fmt;
+    const char *type_str = qualified.data();
+    const char *ns_str = ns.data();
+
+    // Declaration head
+    fmt = "QAS::%sWriter &%soperator<<(QAS::%sWriter &_writer, const %s &_var) {\n";
+    fprintf(fp, fmt, format, ns_str, format, type_str);
+
+    fprintf(fp, "    _writer.beginObject();\n");
+
+    // Super classes, write members into the same object
+    for (const auto &super: table.supers) {
+        fmt = "    _writer.mergeObject();\n"
+              "    _writer << *static_cast<const %s *>(&_var);\n";
+        const char *name_str = super.data();
+        fprintf(fp, fmt, name_str);
+    }
+
+    // Start members
+    for (int i = 0; i < table.members.size(); ++i) {
+        fmt = "    _writer.writeKey(QAS::Utf8View(\"%s\"));\n"
+              "    _writer << _var.%s;\n";
+        fprintf(fp, fmt, table.keys.at(i).data(), table.paths.at(i).data());
+    }
+
+    // Last and end
+    fprintf(fp, "    _writer.endObject();\n"
+                "\n"
+                "    return _writer;\n"
+                "}\n");
+
+    fprintf(fp, "\n");
+}
+
+void Generator::generateClassReader(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                                    const MemberTable &table) {
+    const char *fmt;
+    const char *type_str = qualified.data();
+    const char *ns_str = ns.data();
+
+    // Declaration head
+    fmt = "QAS::%sReader &%soperator>>(QAS::%sReader &_reader, %s &_var) {\n";
+    fprintf(fp, fmt, format, ns_str, format, type_str);
+
+    // Define res, read in place if the reader asks for it and no constraint can reject the result
+    bool validated = false;
+    for (const auto &item: table.members) {
+        validated |= !item->constraintGroups.isEmpty();
+    }
+    fmt = "    QAS::JsonStreamPrivate::UpdateTarget<%s> _target(_var, %s);\n"
+          "    %s &_tmpVar = _target.get();\n"
+          "\n";
+    fprintf(fp, fmt, type_str, validated ? "false" : "_reader.inPlace()", type_str);
+
+    // Super classes, read the same object from the start
+    if (!table.supers.isEmpty()) {
+        fprintf(fp, "    const qint64 _start = _reader.position();\n");
+    }
+    for (const auto &super: table.supers) {
+        const char *name_str = super.data();
+        fmt = "    _reader >> *static_cast<%s *>(&_tmpVar);\n"
+              "    if (!_reader.good()) {\n"
+              "        return _reader;\n"
+              "    }\n"
+              "    _reader.seek(_start);\n";
+        fprintf(fp, fmt, name_str);
+    }
+    if (!table.supers.isEmpty()) {
+        fprintf(fp, "\n");
+    }
+
+    // Convert to object
+    fmt = "    if (!QAS::%sReaderUtils::parseAsObject(_reader, \"%s\")) {\n"
+          "        return _reader;\n"
+          "    }\n\n";
+    fprintf(fp, fmt, format, type_str);
+
+    // Start branches, dispatch by key length and then by bytes
+    if (!table.members.isEmpty()) {
+        fprintf(fp, "    bool _seen[%d] = {};\n", table.members.size());
+
+        // Members outside the mask are never required
+        fprintf(fp, "    if (!_reader.mask().isFull()) {\n");
+        for (int i = 0; i < table.keys.size(); ++i) {
+            fmt = "        _seen[%d] = !_reader.mask().contains(QAS::Utf8View(\"%s\"));\n";
+            fprintf(fp, fmt, i, table.keys.at(i).data());
+        }
+        fprintf(fp, "    }\n");
+    }
+    fprintf(fp, "    QAS::Utf8View _key;\n"
+                "    while (_reader.nextMember(&_key)) {\n");
+    if (!table.members.isEmpty()) {
+        fprintf(fp, "        if (!_reader.mask().isFull() && !_reader.mask().contains(_key)) {\n"
+                    "            if (!_reader.skipValue()) {\n"
+                    "                return _reader;\n"
+                    "            }\n"
+                    "            continue;\n"
+                    "        }\n");
+    }
+    generateKeySwitch(
+        "_key", true, table.keys, 8,
+        [&](int index, const char *pad_str) {
+            const MemberVariableDef &item = *table.members.at(index);
+            const QByteArray &attr = table.keys.at(index);
+            const char *name_str = table.paths.at(index).data();
+            // Constrained members are decoded even when the reader only validates
+            const char *parse_str =
+                    item.constraintGroups.isEmpty() ? "parseObjectMember" : "parseConstrainedMember";
+            fmt = "%sif (!QAS::%sReaderUtils::%s(_reader, \"%s\", \"%s\", &_tmpVar.%s)) {\n"
+                  "%s    return _reader;\n"
+                  "%s}\n"
+                  "%s_seen[%d] = true;\n";
+            fprintf(fp, fmt, pad_str, format, parse_str, attr.data(), type_str, name_str, pad_str, pad_str, pad_str,
+                    index);
+
+            // Generate constraint validation if constraints exist
+            if (!item.constraintGroups.isEmpty()) {
+                generateConstraintValidation("_reader", table.paths.at(index), item.constraintGroups, int(strlen(pad_str)));
+            }
+        },
+        [&](const char *pad_str) {
+            // Unknown keys
+            fmt = "%sif (!_reader.skipValue()) {\n"
+                  "%s    return _reader;\n"
+                  "%s}\n";
+            fprintf(fp, fmt, pad_str, pad_str, pad_str);
+        });
+    fprintf(fp, "    }\n"
+                "    if (!_reader.good()) {\n"
+                "        return _reader;\n"
+                "    }\n");
+
+    // Check missing keys
+    if (!table.members.isEmpty()) {
+        fprintf(fp, "    for (bool _found : _seen) {\n"
+                    "        if (!_found) {\n"
+                    "            _reader.setStatus(QAS::JsonStream::KeyNotFound);\n"
+                    "            return _reader;\n"
+                    "        }\n"
+                    "    }\n");
+    }
+
+    // Last and end
+    fprintf(fp, "    _target.commit();\n"
+                "\n"
+                "    return _reader;\n"
+                "}\n");
+
+    fprintf(fp, "\n");
+}
+
+void Generator::generateKeySwitch(const char *keyName, bool utf8, const QByteArrayList &keys, int indent,
+                                  const BranchGenerator &generateBranch, const FallbackGenerator &generateFallback) {
+    // Group keys by length, the QString key is compared in UTF-16 units and the reader key in UTF-8 bytes
+    QMap<int, QVector<int>> groups;
+    for (int i = 0; i < keys.size(); ++i) {
+        const QByteArray &attr = keys.at(i);
+        groups[utf8 ? attr.size() : QString::fromUtf8(attr).size()].append(i);
+    }
+
+    QByteArray pad(indent, ' ');
+    QByteArray casePad(indent + 4, ' ');
+    QByteArray branchPad(indent + 8, ' ');
+    QByteArray bodyPad(indent + 12, ' ');
+    const char *pad_str = pad.data();
+    const char *case_pad_str = casePad.data();
+    const char *branch_pad_str = branchPad.data();
+
+    if (groups.isEmpty()) {
+        if (generateFallback) {
+            generateFallback(pad_str);
+        }
+        return;
+    }
+
+    fprintf(fp, "%sswitch (%s.size()) {\n", pad_str, keyName);
+    for (auto it = groups.begin(); it != groups.end(); ++it) {
+        fprintf(fp, "%scase %d:\n", case_pad_str, it.key());
+        fprintf(fp, "%s", branch_pad_str);
+        for (int i : it.value()) {
+            const QByteArray &attr = keys.at(i);
+            const char *attr_str = attr.data();
+            if (i != it.value().front()) {
+                fprintf(fp, "%s} else ", branch_pad_str);
+            }
+            if (utf8) {
+                fprintf(fp, "if (memcmp(%s.data(), \"%s\", %d) == 0) {\n", keyName, attr_str, it.key());
+            } else if (QString::fromUtf8(attr) == QString::fromLatin1(attr)) {
+                fprintf(fp, "if (%s == QLatin1String(\"%s\")) {\n", keyName, attr_str);
+            } else {
+                fprintf(fp, "if (%s == QString::fromUtf8(\"%s\")) {\n", keyName, attr_str);
+            }
+            generateBranch(i, bodyPad.data());
+        }
+        if (generateFallback) {
+            fprintf(fp, "%s} else {\n", branch_pad_str);
+            generateFallback(bodyPad.data());
+        }
+        fprintf(fp, "%s}\n", branch_pad_str);
+        fprintf(fp, "%sbreak;\n", branch_pad_str);
+    }
+    fprintf(fp, "%sdefault:\n", case_pad_str);
+    if (generateFallback) {
+        generateFallback(branch_pad_str);
+    }
+    fprintf(fp, "%sbreak;\n", branch_pad_str);
+    fprintf(fp, "%s}\n", pad_str);
+}
+
+void Generator::generateConstraintValidation(const char *streamName, const QByteArray &fieldName, 
+                                            const QVector<ConstraintGroup> &constraintGroups, int indent,
+                                            int failIndex) {
     if (constraintGroups.isEmpty()) {
         return;
     }
     
     const char *field_str = fieldName.data();
+    QByteArray pad(indent, ' ');
+    const char *pad_str = pad.data();
     
-    fprintf(fp, "    // Validate constraints for field '%s'\n", field_str);
-    fprintf(fp, "    {\n");
-    fprintf(fp, "        bool _constraintSatisfied = false;\n");
-    fprintf(fp, "        QJsonValue _fieldValue = QAS::JsonStream::fromValue(_tmpVar.%s).data();\n", field_str);
+    fprintf(fp, "%s// Validate constraints for field '%s'\n", pad_str, field_str);
+    fprintf(fp, "%s{\n", pad_str);
+    fprintf(fp, "%s    bool _constraintSatisfied = false;\n", pad_str);
+    
+    // Build patterns and enumerations once per constraint site
+    int staticIdx = 0;
+    for (const auto &group : constraintGroups) {
+        for (const auto &constraint : group.constraints) {
+            if (constraint.type == ConstraintType::PATTERN) {
+                fprintf(fp, "%s    static const QRegularExpression _pattern%d = QAS::ConstraintValidator::compilePattern(QString(\"%s\"));\n",
+                        pad_str, staticIdx, constraint.value.toString().toUtf8().constData());
+            } else if (constraint.type == ConstraintType::ENUM) {
+                QJsonArray arr = constraint.value.toArray();
+                bool allStrings = !arr.isEmpty();
+                for (const auto &item : arr) {
+                    allStrings = allStrings && item.isString();
+                }
+                if (allStrings) {
+                    fprintf(fp, "%s    static const QSet<QString> _enum%d = {", pad_str, staticIdx);
+                } else {
+                    fprintf(fp, "%s    static const QJsonArray _enum%d = {", pad_str, staticIdx);
+                }
+                for (int i = 0; i < arr.size(); ++i) {
+                    if (i > 0) fprintf(fp, ", ");
+                    QJsonValue item = arr[i];
+                    if (item.isString()) {
+                        fprintf(fp, "QStringLiteral(\"%s\")", item.toString().toUtf8().constData());
+                    } else if (item.isDouble()) {
+                        fprintf(fp, "%s", QByteArray::number(item.toDouble(), 'g', 17).constData());
+                    } else if (item.isBool()) {
+                        fprintf(fp, "%s", item.toBool() ? "true" : "false");
+                    } else if (item.isNull()) {
+                        fprintf(fp, "QJsonValue(QJsonValue::Null)");
+                    }
+                }
+                fprintf(fp, "};\n");
+            } else {
+                continue;
+            }
+            staticIdx++;
+        }
+    }
+    staticIdx = 0;
     
     // Generate validation for each constraint group (OR relationship)
     for (int groupIdx = 0; groupIdx < constraintGroups.size(); ++groupIdx) {
         const auto &group = constraintGroups[groupIdx];
         
         if (groupIdx == 0) {
-            fprintf(fp, "        if (");
+            fprintf(fp, "%s    if (", pad_str);
         } else {
-            fprintf(fp, "        } else if (");
+            fprintf(fp, "%s    } else if (", pad_str);
         }
         
         // Generate validation for each constraint in the group (AND relationship)
@@ -429,89 +939,87 @@ void Generator::generateConstraintValidation(const QByteArray &fieldName,
             }
             
             // Generate specific constraint validation based on type
-            generateSingleConstraintCheck(constraint);
+            bool hasStatic = constraint.type == ConstraintType::PATTERN || constraint.type == ConstraintType::ENUM;
+            generateSingleConstraintCheck(constraint, fieldName, hasStatic ? staticIdx++ : -1);
         }
         
         fprintf(fp, ") {\n");
-        fprintf(fp, "            _constraintSatisfied = true;\n");
+        fprintf(fp, "%s        _constraintSatisfied = true;\n", pad_str);
     }
     
     if (!constraintGroups.isEmpty()) {
-        fprintf(fp, "        }\n");
+        fprintf(fp, "%s    }\n", pad_str);
     }
     
-    fprintf(fp, "        if (!_constraintSatisfied) {\n");
-    fprintf(fp, "            _stream.setStatus(QAS::JsonStream::ConstraintViolation);\n");
-    fprintf(fp, "            return _stream;\n");
-    fprintf(fp, "        }\n");
-    fprintf(fp, "    }\n");
+    fprintf(fp, "%s    if (!_constraintSatisfied) {\n", pad_str);
+    if (failIndex >= 0) {
+        // Inside the object walk, record the member and go on with the next key
+        fprintf(fp, "%s        _failIndex = %d;\n", pad_str, failIndex);
+        fprintf(fp, "%s        _failStatus = QAS::JsonStream::ConstraintViolation;\n", pad_str);
+        fprintf(fp, "%s        continue;\n", pad_str);
+    } else {
+        fprintf(fp, "%s        %s.setStatus(QAS::JsonStream::ConstraintViolation);\n", pad_str, streamName);
+        fprintf(fp, "%s        return %s;\n", pad_str, streamName);
+    }
+    fprintf(fp, "%s    }\n", pad_str);
+    fprintf(fp, "%s}\n", pad_str);
 }
 
-void Generator::generateSingleConstraintCheck(const Constraint &constraint) {
+void Generator::generateSingleConstraintCheck(const Constraint &constraint, const QByteArray &fieldName,
+                                              int staticIdx) {
     QJsonValue value = constraint.value;
+    const char *field_str = fieldName.data();
     
     switch (constraint.type) {
         case ConstraintType::MINIMUM:
-            fprintf(fp, "QAS::ConstraintValidator::validateMinimum(_fieldValue, QJsonValue(%g))", value.toDouble());
+            fprintf(fp, "QAS::ConstraintValidator::validateMinimum(_tmpVar.%s, %s)", field_str,
+                    constraintNumber(value.toDouble()).constData());
             break;
             
         case ConstraintType::MAXIMUM:
-            fprintf(fp, "QAS::ConstraintValidator::validateMaximum(_fieldValue, QJsonValue(%g))", value.toDouble());
+            fprintf(fp, "QAS::ConstraintValidator::validateMaximum(_tmpVar.%s, %s)", field_str,
+                    constraintNumber(value.toDouble()).constData());
             break;
             
         case ConstraintType::EXCLUSIVE_MINIMUM:
-            fprintf(fp, "QAS::ConstraintValidator::validateExclusiveMinimum(_fieldValue, QJsonValue(%g))", value.toDouble());
+            fprintf(fp, "QAS::ConstraintValidator::validateExclusiveMinimum(_tmpVar.%s, %s)", field_str,
+                    constraintNumber(value.toDouble()).constData());
             break;
             
         case ConstraintType::EXCLUSIVE_MAXIMUM:
-            fprintf(fp, "QAS::ConstraintValidator::validateExclusiveMaximum(_fieldValue, QJsonValue(%g))", value.toDouble());
+            fprintf(fp, "QAS::ConstraintValidator::validateExclusiveMaximum(_tmpVar.%s, %s)", field_str,
+                    constraintNumber(value.toDouble()).constData());
             break;
             
         case ConstraintType::CONST:
             if (value.isString()) {
-                fprintf(fp, "QAS::ConstraintValidator::validateConst(_fieldValue, QJsonValue(QString(\"%s\")))", 
-                       value.toString().toUtf8().constData());
+                fprintf(fp, "QAS::ConstraintValidator::validateConst(_tmpVar.%s, %s)", field_str,
+                        constraintString(value.toString()).constData());
             } else if (value.isDouble()) {
-                fprintf(fp, "QAS::ConstraintValidator::validateConst(_fieldValue, QJsonValue(%g))", value.toDouble());
+                fprintf(fp, "QAS::ConstraintValidator::validateConst(_tmpVar.%s, %s)", field_str,
+                        constraintNumber(value.toDouble()).constData());
             } else if (value.isBool()) {
-                fprintf(fp, "QAS::ConstraintValidator::validateConst(_fieldValue, QJsonValue(%s))", 
-                       value.toBool() ? "true" : "false");
+                fprintf(fp, "QAS::ConstraintValidator::validateConst(_tmpVar.%s, %s)", field_str,
+                        value.toBool() ? "true" : "false");
             } else if (value.isNull()) {
-                fprintf(fp, "QAS::ConstraintValidator::validateConst(_fieldValue, QJsonValue(QJsonValue::Null))");
+                fprintf(fp, "QAS::ConstraintValidator::validateConst(_tmpVar.%s, nullptr)", field_str);
             }
             break;
             
-        case ConstraintType::ENUM: {
-            fprintf(fp, "QAS::ConstraintValidator::validateEnum(_fieldValue, QJsonValue(QJsonArray({");
-            QJsonArray arr = value.toArray();
-            for (int i = 0; i < arr.size(); ++i) {
-                if (i > 0) fprintf(fp, ", ");
-                QJsonValue item = arr[i];
-                if (item.isString()) {
-                    fprintf(fp, "QString(\"%s\")", item.toString().toUtf8().constData());
-                } else if (item.isDouble()) {
-                    fprintf(fp, "%g", item.toDouble());
-                } else if (item.isBool()) {
-                    fprintf(fp, "%s", item.toBool() ? "true" : "false");
-                } else if (item.isNull()) {
-                    fprintf(fp, "QJsonValue(QJsonValue::Null)");
-                }
-            }
-            fprintf(fp, "})))");
+        case ConstraintType::ENUM:
+            fprintf(fp, "QAS::ConstraintValidator::validateEnum(_tmpVar.%s, _enum%d)", field_str, staticIdx);
             break;
-        }
         
         case ConstraintType::MIN_LENGTH:
-            fprintf(fp, "QAS::ConstraintValidator::validateMinLength(_fieldValue, QJsonValue(%d))", value.toInt());
+            fprintf(fp, "QAS::ConstraintValidator::validateMinLength(_tmpVar.%s, %d)", field_str, value.toInt());
             break;
             
         case ConstraintType::MAX_LENGTH:
-            fprintf(fp, "QAS::ConstraintValidator::validateMaxLength(_fieldValue, QJsonValue(%d))", value.toInt());
+            fprintf(fp, "QAS::ConstraintValidator::validateMaxLength(_tmpVar.%s, %d)", field_str, value.toInt());
             break;
             
         case ConstraintType::PATTERN:
-            fprintf(fp, "QAS::ConstraintValidator::validatePattern(_fieldValue, QJsonValue(QString(\"%s\")))", 
-                   value.toString().toUtf8().constData());
+            fprintf(fp, "QAS::ConstraintValidator::validatePattern(_tmpVar.%s, _pattern%d)", field_str, staticIdx);
             break;
             
         default:
@@ -3,6 +3,8 @@
 
 #include "qasc.h"
 
+#include <functional>
+
 class Generator {
     Environment *rootEnv;
     FILE *fp;
@@ -13,17 +15,52 @@ public:
     void generateCode();
 
 private:
+    // Class generated in this file
+    struct ClassInfo {
+        const ClassDef *def;
+        QByteArrayList supers;
+        QVector<bool> publicSupers;
+    };
+    QHash<QByteArray, ClassInfo> classInfos;
+
+    // Members taking part in conversion, the bases generated in this file can be flattened into it
+    struct MemberTable {
+        QVector<const MemberVariableDef *> members;
+        QByteArrayList keys;
+        QByteArrayList paths;  // Member expression of _var, qualified for inherited ones
+        QByteArrayList supers; // Bases converted by their own operators
+    };
+    MemberTable memberTable(const QByteArrayList &supers, const ClassDef &def, bool flatten) const;
+    bool flattenBase(const QByteArray &qualified, MemberTable *table) const;
+
     // void generateUsing(const QByteArray &qualified);
 
     void generateEnums(const QByteArray &ns, const QByteArray &qualified, const EnumDef &def);
 
     void generateClass(const QByteArray &ns, const QByteArray &qualified,
                        const QByteArrayList &supers, const ClassDef &def);
+
+    // Generate the streaming operators of a format, "Json" or "Cbor"
+    void generateEnumWriter(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                            const QByteArrayList &keys, const QVector<const JsonAttributes *> &values);
+    void generateEnumReader(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                            const QByteArrayList &keys, const QVector<const JsonAttributes *> &values);
+    void generateClassWriter(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                             const MemberTable &table);
+    void generateClassReader(const char *format, const QByteArray &ns, const QByteArray &qualified,
+                             const MemberTable &table);
+
+    // Generate a switch on key length, then compare the keys of the same length
+    using BranchGenerator = std::function<void(int, const char *)>;
+    using FallbackGenerator = std::function<void(const char *)>;
+    void generateKeySwitch(const char *keyName, bool utf8, const QByteArrayList &keys, int indent,
+                           const BranchGenerator &generateBranch, const FallbackGenerator &generateFallback);
                        
     // Generate constraint validation code
-    void generateConstraintValidation(const QByteArray &fieldName, 
-                                     const QVector<ConstraintGroup> &constraintGroups);
-    void generateSingleConstraintCheck(const Constraint &constraint);
+    void generateConstraintValidation(const char *streamName, const QByteArray &fieldName, 
+                                     const QVector<ConstraintGroup> &constraintGroups, int indent = 4,
+                                     int failIndex = -1);
+    void generateSingleConstraintCheck(const Constraint &constraint, const QByteArray &fieldName, int staticIdx = -1);
 };
 
 #endif // GENERATOR_H